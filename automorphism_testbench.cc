@@ -0,0 +1,121 @@
+/*
+Test bench for automorphism ensemble decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+#include "polar_automorphism_decoder.hh"
+
+int main()
+{
+	const int M = 8;
+	const int N = 1 << M;
+	const int L = 8;
+	typedef int8_t code_type;
+#ifdef __AVX2__
+	const int SIZEOF_SIMD = 32;
+#else
+	const int SIZEOF_SIMD = 16;
+#endif
+	const int SIMD_WIDTH = SIZEOF_SIMD / sizeof(code_type);
+	typedef SIMD<code_type, SIMD_WIDTH> simd_type;
+	typedef std::default_random_engine generator;
+	typedef std::uniform_int_distribution<int> distribution;
+	auto data = std::bind(distribution(0, 1), generator(1));
+	auto frozen = new uint8_t[N];
+	auto codeword = new code_type[N];
+
+	long double erasure_probability = 0.5;
+	int K = (1 - erasure_probability) * N;
+	double design_SNR = 10 * std::log10(-std::log(erasure_probability));
+	auto message = new code_type[K];
+	auto decoded = new code_type[K];
+	PolarEncoder<code_type, M> encode;
+	auto program = new uint8_t[N];
+	PolarCompiler compile;
+	std::cerr << "sizeof(PolarAutomorphismDecoder<simd_type, M>) = " << sizeof(PolarAutomorphismDecoder<simd_type, M>) << std::endl;
+	auto automorphism = new PolarAutomorphismDecoder<simd_type, M>;
+	auto sc = new PolarDecoder<code_type, M>;
+	auto list = new PolarListDecoder<code_type, M, L>;
+
+	auto symb = new double[N];
+	for (int profile = 0; profile < 2; ++profile) {
+		long double probability = std::exp(-pow(10.0, (design_SNR + 1.59175) / 10));
+		if (profile) {
+			auto freeze = new PolarRMProfile<M>;
+			(*freeze)(frozen, M, K, probability);
+			delete freeze;
+		} else {
+			auto freeze = new PolarCodeConst0<M>;
+			(*freeze)(frozen, M, K, probability);
+			delete freeze;
+		}
+		compile(program, frozen, M);
+		std::cerr << "Polar(" << N << ", " << K << ") from " << (profile ? "PolarRMProfile" : "PolarCodeConst0") << std::endl;
+		std::cerr << "SNR FER(SC) FER(SCL" << L << ") FER(AE" << SIMD_WIDTH << ") Mbit/s(SC) Mbit/s(SCL" << L << ") Mbit/s(AE" << SIMD_WIDTH << ")" << std::endl;
+		for (double SNR = -0.5; SNR <= 0.5; SNR += 0.5) {
+			double sigma_signal = 1;
+			double mean_noise = 0;
+			double sigma_noise = std::sqrt(sigma_signal * sigma_signal / (2 * std::pow(10, SNR / 10)));
+
+			typedef std::normal_distribution<double> normal;
+			auto awgn = std::bind(normal(mean_noise, sigma_noise), generator(2));
+
+			int64_t frame_errors[3] = { 0 };
+			double usec[3] = { 0 };
+			int64_t loops = 10000;
+			for (int64_t loop = 0; loop < loops; ++loop) {
+				for (int i = 0; i < K; ++i)
+					message[i] = 1 - 2 * data();
+				encode(codeword, message, frozen);
+
+				for (int i = 0; i < N; ++i)
+					symb[i] = codeword[i] + awgn();
+
+				double DIST = 2; // BPSK
+				double fact = DIST / (sigma_noise * sigma_noise);
+				for (int i = 0; i < N; ++i)
+					codeword[i] = PolarHelper<code_type>::quant(fact * symb[i]);
+
+				for (int d = 0; d < 3; ++d) {
+					auto start = std::chrono::system_clock::now();
+					if (d == 2)
+						(*automorphism)(decoded, codeword, program, frozen);
+					else if (d)
+						(*list)(decoded, codeword, program, L);
+					else
+						(*sc)(decoded, codeword, program);
+					auto end = std::chrono::system_clock::now();
+					usec[d] += std::chrono::duration<double, std::micro>(end - start).count();
+					int errors = 0;
+					for (int i = 0; i < K; ++i)
+						errors += decoded[i] * message[i] <= 0;
+					frame_errors[d] += !!errors;
+				}
+			}
+
+			std::cout << SNR;
+			for (int d = 0; d < 3; ++d)
+				std::cout << " " << (double)frame_errors[d] / (double)loops;
+			for (int d = 0; d < 3; ++d)
+				std::cout << " " << (double)(loops * K) / usec[d];
+			std::cout << std::endl;
+		}
+	}
+	return 0;
+}
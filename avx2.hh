@@ -470,6 +470,14 @@ inline SIMD<double, 4> vmul(SIMD<double, 4> a, SIMD<double, 4> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 16> vmul(SIMD<int16_t, 16> a, SIMD<int16_t, 16> b)
+{
+	SIMD<int16_t, 16> tmp;
+	tmp.m = _mm256_mullo_epi16(a.m, b.m);
+	return tmp;
+}
+
 template <>
 inline SIMD<float, 8> vabs(SIMD<float, 8> a)
 {
@@ -1188,3 +1196,52 @@ inline SIMD<float, 8> vshuf(SIMD<float, 8> a, SIMD<uint32_t, 8> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 16> vshr(SIMD<int16_t, 16> a, int n)
+{
+	SIMD<int16_t, 16> tmp;
+	tmp.m = _mm256_sra_epi16(a.m, _mm_cvtsi32_si128(n));
+	return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 32> vqmovn(SIMD<int16_t, 16> a, SIMD<int16_t, 16> b)
+{
+	SIMD<int8_t, 32> tmp;
+	tmp.m = _mm256_permute4x64_epi64(_mm256_packs_epi16(a.m, b.m), 0xd8);
+	return tmp;
+}
+
+template <>
+inline SIMD<int16_t, 16> vmovl_low(SIMD<int8_t, 32> a)
+{
+	SIMD<int16_t, 16> tmp;
+	tmp.m = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(a.m));
+	return tmp;
+}
+
+template <>
+inline SIMD<int16_t, 16> vmovl_high(SIMD<int8_t, 32> a)
+{
+	SIMD<int16_t, 16> tmp;
+	tmp.m = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(a.m, 1));
+	return tmp;
+}
+
+#ifdef __F16C__
+template <>
+inline SIMD<float, 8> vcvt_float(SIMD<uint16_t, 8> a)
+{
+	SIMD<float, 8> tmp;
+	tmp.m = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)a.v));
+	return tmp;
+}
+
+template <>
+inline SIMD<uint16_t, 8> vcvt_half(SIMD<float, 8> a)
+{
+	SIMD<uint16_t, 8> tmp;
+	_mm_storeu_si128((__m128i *)tmp.v, _mm256_cvtps_ph(a.m, _MM_FROUND_TO_NEAREST_INT));
+	return tmp;
+}
+#endif
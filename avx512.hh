@@ -0,0 +1,76 @@
+/*
+Intel AVX-512 acceleration
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+#include <immintrin.h>
+
+template <>
+union SIMD<uint64_t, 8>
+{
+	static const int SIZE = 8;
+	typedef uint64_t value_type;
+	typedef uint64_t uint_type;
+	__m512i m;
+	value_type v[SIZE];
+	uint_type u[SIZE];
+};
+
+template <>
+inline SIMD<uint64_t, 8> vdup<SIMD<uint64_t, 8>>(uint64_t a)
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_set1_epi64(a);
+	return tmp;
+}
+
+template <>
+inline SIMD<uint64_t, 8> vzero()
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_setzero_si512();
+	return tmp;
+}
+
+template <>
+inline SIMD<uint64_t, 8> vorr(SIMD<uint64_t, 8> a, SIMD<uint64_t, 8> b)
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_or_si512(a.m, b.m);
+	return tmp;
+}
+
+template <>
+inline SIMD<uint64_t, 8> vand(SIMD<uint64_t, 8> a, SIMD<uint64_t, 8> b)
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_and_si512(a.m, b.m);
+	return tmp;
+}
+
+template <>
+inline SIMD<uint64_t, 8> veor(SIMD<uint64_t, 8> a, SIMD<uint64_t, 8> b)
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_xor_si512(a.m, b.m);
+	return tmp;
+}
+
+template <>
+inline SIMD<uint64_t, 8> vbic(SIMD<uint64_t, 8> a, SIMD<uint64_t, 8> b)
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_ternarylogic_epi64(a.m, b.m, b.m, 0x30);
+	return tmp;
+}
+
+template <>
+inline SIMD<uint64_t, 8> vbsl(SIMD<uint64_t, 8> a, SIMD<uint64_t, 8> b, SIMD<uint64_t, 8> c)
+{
+	SIMD<uint64_t, 8> tmp;
+	tmp.m = _mm512_ternarylogic_epi64(a.m, b.m, c.m, 0xca);
+	return tmp;
+}
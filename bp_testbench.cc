@@ -0,0 +1,127 @@
+/*
+Test bench for belief propagation decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+#include "polar_bp_decoder.hh"
+
+int main()
+{
+	const int M = 10;
+	const int N = 1 << M;
+	const int I = 50;
+	typedef int8_t code_type;
+#ifdef __AVX2__
+	const int SIZEOF_SIMD = 32;
+#else
+	const int SIZEOF_SIMD = 16;
+#endif
+	const int SIMD_WIDTH = SIZEOF_SIMD / sizeof(code_type);
+	typedef SIMD<code_type, SIMD_WIDTH> simd_type;
+	typedef PolarHelper<simd_type> PH;
+	typedef std::default_random_engine generator;
+	typedef std::uniform_int_distribution<int> distribution;
+	auto data = std::bind(distribution(0, 1), generator(1));
+	auto frozen = new uint8_t[N];
+
+	long double erasure_probability = 0.5;
+	int K = (1 - erasure_probability) * N;
+	double design_SNR = 10 * std::log10(-std::log(erasure_probability));
+	{
+		auto freeze = new PolarCodeConst0<M>;
+		long double probability = std::exp(-pow(10.0, (design_SNR + 1.59175) / 10));
+		(*freeze)(frozen, M, K, probability);
+		delete freeze;
+	}
+	std::cerr << "Polar(" << N << ", " << K << ") with up to " << I << " iterations" << std::endl;
+	auto message = new simd_type[K];
+	auto decoded = new simd_type[K];
+	auto codeword = new simd_type[N];
+	PolarEncoder<simd_type, M> encode;
+	auto program = new uint8_t[N];
+	PolarCompiler compile;
+	compile(program, frozen, M);
+	auto sc = new PolarDecoder<simd_type, M>;
+	auto bp = new PolarBPDecoder<simd_type, M>;
+	auto errors = [&]() {
+		int frames = 0;
+		for (int k = 0; k < SIMD_WIDTH; ++k) {
+			int errs = 0;
+			for (int i = 0; i < K; ++i)
+				errs += PH::get(decoded[i], k) * PH::get(message[i], k) <= 0;
+			frames += !!errs;
+		}
+		return frames;
+	};
+
+	auto symb = new double[SIMD_WIDTH*N];
+	int result[SIMD_WIDTH];
+	std::cerr << "SNR FER(SC) FER(BP) Mbit/s(SC) Mbit/s(BP) iterations/frame iterations/batch" << std::endl;
+	for (double SNR = -1; SNR <= 1; SNR += 0.5) {
+		double sigma_signal = 1;
+		double mean_noise = 0;
+		double sigma_noise = std::sqrt(sigma_signal * sigma_signal / (2 * std::pow(10, SNR / 10)));
+
+		typedef std::normal_distribution<double> normal;
+		auto awgn = std::bind(normal(mean_noise, sigma_noise), generator(2));
+
+		int64_t frame_errors[2] = { 0 };
+		double usec[2] = { 0 };
+		int64_t iterations = 0, sweeps = 0;
+		int64_t loops = 32000 / SIMD_WIDTH;
+		for (int64_t loop = 0; loop < loops; ++loop) {
+			for (int i = 0; i < K; ++i)
+				for (int k = 0; k < SIMD_WIDTH; ++k)
+					PH::set(message+i, k, 1 - 2 * data());
+			encode(codeword, message, frozen);
+
+			for (int i = 0; i < N; ++i)
+				for (int k = 0; k < SIMD_WIDTH; ++k)
+					symb[SIMD_WIDTH*i+k] = PH::get(codeword[i], k) + awgn();
+
+			double DIST = 2; // BPSK
+			double fact = DIST / (sigma_noise * sigma_noise);
+			for (int i = 0; i < N; ++i)
+				for (int k = 0; k < SIMD_WIDTH; ++k)
+					PH::set(codeword+i, k, PolarHelper<code_type>::quant(fact * symb[SIMD_WIDTH*i+k]));
+
+			for (int d = 0; d < 2; ++d) {
+				auto start = std::chrono::system_clock::now();
+				if (d)
+					sweeps += (*bp)(result, decoded, codeword, frozen, M, I);
+				else
+					(*sc)(decoded, codeword, program);
+				auto end = std::chrono::system_clock::now();
+				usec[d] += std::chrono::duration<double, std::micro>(end - start).count();
+				frame_errors[d] += errors();
+			}
+			for (int k = 0; k < SIMD_WIDTH; ++k)
+				iterations += result[k] < 0 ? I : result[k];
+		}
+
+		int64_t frames = SIMD_WIDTH * loops;
+		std::cout << SNR;
+		for (int d = 0; d < 2; ++d)
+			std::cout << " " << (double)frame_errors[d] / (double)frames;
+		for (int d = 0; d < 2; ++d)
+			std::cout << " " << (double)(frames * K) / usec[d];
+		std::cout << " " << (double)iterations / (double)frames << " " << (double)sweeps / (double)loops << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,32 @@
+/*
+Cyclic redundancy check
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE>
+class CRC
+{
+	TYPE poly;
+	TYPE crc;
+public:
+	CRC(TYPE poly, TYPE crc = 0) : poly(poly), crc(crc) {}
+	void reset(TYPE v = 0)
+	{
+		crc = v;
+	}
+	TYPE operator()()
+	{
+		return crc;
+	}
+	TYPE operator()(bool data)
+	{
+		TYPE tmp = crc ^ data;
+		crc >>= 1;
+		if (tmp & 1)
+			crc ^= poly;
+		return crc;
+	}
+};
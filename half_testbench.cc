@@ -0,0 +1,136 @@
+/*
+Test bench for successive cancellation decoding of polar codes with half precision storage
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+#include "polar_half_decoder.hh"
+
+#ifdef __AVX2__
+const int SIZEOF_SIMD = 32;
+#else
+const int SIZEOF_SIMD = 16;
+#endif
+const int SIMD_WIDTH = SIZEOF_SIMD / sizeof(float);
+typedef SIMD<float, SIMD_WIDTH> float_type;
+typedef SIMD<half_t, SIMD_WIDTH> half_type;
+typedef std::default_random_engine generator;
+
+template <int M>
+void run(double SNR, int loops)
+{
+	const int N = 1 << M;
+	typedef PolarHelper<float_type> PF;
+	auto data = std::bind(std::uniform_int_distribution<int>(0, 1), generator(1));
+	auto frozen = new uint8_t[N];
+
+	long double erasure_probability = 0.5;
+	int K = (1 - erasure_probability) * N;
+	double design_SNR = 10 * std::log10(-std::log(erasure_probability));
+	{
+		auto freeze = new PolarCodeConst0<M>;
+		long double probability = std::exp(-pow(10.0, (design_SNR + 1.59175) / 10));
+		(*freeze)(frozen, M, K, probability);
+		delete freeze;
+	}
+	auto message = new float_type[K];
+	auto decoded = new float_type[K];
+	auto codeword = new float_type[N];
+	auto stored = new half_type[N];
+	PolarEncoder<float_type, M> encode;
+	auto program = new uint8_t[N];
+	PolarCompiler compile;
+	compile(program, frozen, M);
+	auto single = new PolarDecoder<float_type, M>;
+	auto half = new PolarHalfDecoder<M, SIMD_WIDTH>;
+
+	double sigma_signal = 1;
+	double mean_noise = 0;
+	double sigma_noise = std::sqrt(sigma_signal * sigma_signal / (2 * std::pow(10, SNR / 10)));
+
+	typedef std::normal_distribution<double> normal;
+	auto awgn = std::bind(normal(mean_noise, sigma_noise), generator(2));
+
+	int64_t frame_errors[2] = { 0 };
+	double usec[2] = { 0 };
+	for (int loop = 0; loop < loops; ++loop) {
+		for (int i = 0; i < K; ++i)
+			for (int k = 0; k < SIMD_WIDTH; ++k)
+				PF::set(message+i, k, 1 - 2 * data());
+		encode(codeword, message, frozen);
+
+		double DIST = 2; // BPSK
+		double fact = DIST / (sigma_noise * sigma_noise);
+		for (int i = 0; i < N; ++i) {
+			for (int k = 0; k < SIMD_WIDTH; ++k) {
+				float value = fact * (PF::get(codeword[i], k) + awgn());
+				PF::set(codeword+i, k, value);
+				stored[i].m.v[k] = float_to_half(value);
+			}
+		}
+
+		// the best of a few runs keeps page faults and timer noise out of the figures
+		for (int d = 0; d < 2; ++d) {
+			double best = std::numeric_limits<double>::max();
+			for (int r = 0; r < 3; ++r) {
+				auto start = std::chrono::system_clock::now();
+				if (d)
+					(*half)(decoded, stored, program);
+				else
+					(*single)(decoded, codeword, program);
+				auto end = std::chrono::system_clock::now();
+				best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+			}
+			usec[d] += best;
+			for (int k = 0; k < SIMD_WIDTH; ++k) {
+				int errors = 0;
+				for (int i = 0; i < K; ++i)
+					errors += PF::get(decoded[i], k) * PF::get(message[i], k) <= 0;
+				frame_errors[d] += !!errors;
+			}
+		}
+	}
+
+	int64_t frames = SIMD_WIDTH * loops;
+	std::cout << N << " " << SNR;
+	for (int d = 0; d < 2; ++d)
+		std::cout << " " << (double)frame_errors[d] / (double)frames;
+	for (int d = 0; d < 2; ++d)
+		std::cout << " " << (double)(frames * K) / usec[d];
+	std::cout << " " << usec[0] / usec[1] << std::endl;
+
+	delete[] frozen;
+	delete[] message;
+	delete[] decoded;
+	delete[] codeword;
+	delete[] stored;
+	delete[] program;
+	delete single;
+	delete half;
+}
+
+int main()
+{
+	std::cerr << "float against half_t storage with " << SIMD_WIDTH << " lanes" << std::endl;
+	std::cerr << "N SNR FER(float) FER(half) Mbit/s(float) Mbit/s(half) ratio" << std::endl;
+	run<10>(-1, 1000);
+	run<10>(0, 1000);
+	run<16>(-1, 16);
+	run<18>(-1, 4);
+	return 0;
+}
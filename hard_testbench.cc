@@ -0,0 +1,165 @@
+/*
+Test bench for hard decision and erasure decoding of polar codes on bit-sliced frames
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+#include "polar_hard_decoder.hh"
+
+typedef int8_t code_type;
+#ifdef __AVX2__
+const int SIZEOF_SIMD = 32;
+#else
+const int SIZEOF_SIMD = 16;
+#endif
+const int SIMD_WIDTH = SIZEOF_SIMD / sizeof(code_type);
+typedef SIMD<code_type, SIMD_WIDTH> simd_type;
+typedef std::default_random_engine generator;
+
+// frames go through the binary symmetric channel when erasures are off, else through the binary erasure channel
+template <int M, int WIDTH>
+void run(double probability, int K, long double design, int loops, bool erasures)
+{
+	const int N = 1 << M;
+	const int FRAMES = 64 * WIDTH;
+	const int BATCHES = FRAMES / SIMD_WIDTH;
+	typedef SIMD<uint64_t, WIDTH> plane_type;
+	typedef PolarHelper<simd_type> PH;
+	auto data = std::bind(std::uniform_int_distribution<int>(0, 1), generator(1));
+	auto channel = std::bind(std::uniform_real_distribution<double>(0, 1), generator(2));
+	auto frozen = new uint8_t[N];
+	{
+		auto freeze = new PolarCodeConst0<M>;
+		(*freeze)(frozen, M, K, design);
+		delete freeze;
+	}
+	auto program = new uint8_t[N+2];
+	PolarCompiler compile;
+	compile(program, frozen, M);
+	PolarEncoder<code_type, M> encode;
+	auto decode = new PolarDecoder<simd_type, M>;
+	auto hard = new PolarHardDecoder<M, WIDTH>;
+	auto message = new code_type[FRAMES*K];
+	auto codeword = new code_type[N];
+	auto soft = new simd_type[BATCHES*N];
+	auto decoded = new simd_type[BATCHES*N];
+	auto bits = new plane_type[N];
+	auto erased = new plane_type[N];
+	auto planes = new plane_type[N];
+
+	int64_t frame_errors[2] = { 0 };
+	int64_t guessed = 0;
+	double usec[2] = { 0 };
+	for (int loop = 0; loop < loops; ++loop) {
+		for (int i = 0; i < N; ++i)
+			bits[i] = erased[i] = vzero<plane_type>();
+		for (int f = 0; f < FRAMES; ++f) {
+			code_type *mesg = message + K * f;
+			for (int i = 0; i < K; ++i)
+				mesg[i] = 1 - 2 * data();
+			encode(codeword, mesg, frozen);
+			for (int i = 0; i < N; ++i) {
+				bool hit = channel() < probability;
+				code_type value = codeword[i];
+				if (hit && !erasures)
+					value = -value;
+				bits[i].v[f/64] |= uint64_t(value < 0) << (f%64);
+				erased[i].v[f/64] |= uint64_t(hit && erasures) << (f%64);
+				if (erasures)
+					value = hit ? 0 : value * 127;
+				PH::set(soft+N*(f/SIMD_WIDTH)+i, f%SIMD_WIDTH, value);
+			}
+		}
+
+		// the best of a few runs keeps page faults and timer noise out of the figures
+		plane_type guess = vzero<plane_type>();
+		for (int d = 0; d < 2; ++d) {
+			double best = std::numeric_limits<double>::max();
+			for (int r = 0; r < 3; ++r) {
+				auto start = std::chrono::system_clock::now();
+				if (!d)
+					for (int b = 0; b < BATCHES; ++b)
+						(*decode)(decoded+N*b, soft+N*b, program);
+				else if (erasures)
+					guess = (*hard)(planes, bits, erased, program);
+				else
+					(*hard)(planes, bits, program);
+				auto end = std::chrono::system_clock::now();
+				best = std::min(best, std::chrono::duration<double, std::micro>(end - start).count());
+			}
+			usec[d] += best;
+		}
+
+		for (int f = 0; f < FRAMES; ++f) {
+			const code_type *mesg = message + K * f;
+			int errors[2] = { 0 };
+			for (int i = 0; i < K; ++i) {
+				errors[0] += PH::get(decoded[N*(f/SIMD_WIDTH)+i], f%SIMD_WIDTH) != mesg[i];
+				errors[1] += int(planes[i].v[f/64] >> (f%64) & 1) != (mesg[i] < 0);
+			}
+			bool flagged = guess.v[f/64] >> (f%64) & 1;
+			assert(flagged || !errors[1] || !erasures);
+			guessed += flagged;
+			for (int d = 0; d < 2; ++d)
+				frame_errors[d] += !!errors[d];
+		}
+	}
+
+	int64_t frames = FRAMES * loops;
+	std::cout << (erasures ? "BEC " : "BSC ") << N << " " << K << " " << probability;
+	for (int d = 0; d < 2; ++d)
+		std::cout << " " << (double)frame_errors[d] / (double)frames;
+	for (int d = 0; d < 2; ++d)
+		std::cout << " " << (double)(frames * K) / usec[d];
+	std::cout << " " << usec[0] / usec[1];
+	if (erasures)
+		std::cout << " " << (double)guessed / (double)frames;
+	std::cout << std::endl;
+
+	delete[] frozen;
+	delete[] program;
+	delete decode;
+	delete hard;
+	delete[] message;
+	delete[] codeword;
+	delete[] soft;
+	delete[] decoded;
+	delete[] bits;
+	delete[] erased;
+	delete[] planes;
+}
+
+int main()
+{
+#ifdef __AVX512F__
+	const int WIDTH = 8;
+#elif defined(__AVX2__)
+	const int WIDTH = 4;
+#else
+	const int WIDTH = 2;
+#endif
+	std::cerr << "int8_t decoder with " << SIMD_WIDTH << " lanes against " << 64 * WIDTH << " bit-sliced frames" << std::endl;
+	std::cerr << "channel N K probability FER(int8) FER(hard) Mbit/s(int8) Mbit/s(hard) speedup [guessed]" << std::endl;
+	run<8, WIDTH>(0.02, 128, std::exp(-1.L), 32, false);
+	run<11, WIDTH>(0.03, 1024, std::exp(-1.L), 16, false);
+	run<11, WIDTH>(0.04, 1024, std::exp(-1.L), 16, false);
+	run<10, WIDTH>(0.45, 397, 0.4, 16, true);
+	run<16, WIDTH>(0.42, 33614, 0.4, 1, true);
+	run<20, 1>(0.4, 581338, 0.4, 1, true);
+	return 0;
+}
@@ -0,0 +1,173 @@
+/*
+Test bench for successive cancellation list decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "crc.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+
+int main()
+{
+	const int M = 11;
+	const int N = 1 << M;
+	const int L = 8;
+	const int C = 16;
+	const bool systematic = true;
+#if 1
+	typedef int8_t code_type;
+#else
+	typedef float code_type;
+#endif
+	std::random_device rd;
+	typedef std::default_random_engine generator;
+	typedef std::uniform_int_distribution<int> distribution;
+	auto data = std::bind(distribution(0, 1), generator(rd()));
+	auto frozen = new uint8_t[N];
+	auto codeword = new code_type[N];
+
+	long double erasure_probability = 0.5;
+	int K = (1 - erasure_probability) * N;
+	double design_SNR = 10 * std::log10(-std::log(erasure_probability));
+	std::cerr << "design SNR: " << design_SNR << std::endl;
+	{
+		auto freeze = new PolarCodeConst0<M>;
+		double better_SNR = design_SNR + 1.59175;
+		std::cerr << "better SNR: " << better_SNR << std::endl;
+		long double probability = std::exp(-pow(10.0, better_SNR / 10));
+		(*freeze)(frozen, M, K, probability);
+		delete freeze;
+	}
+	std::cerr << "Polar(" << N << ", " << K << ") with CRC" << C << " and list size " << L << std::endl;
+	auto message = new code_type[K];
+	auto decoded = new code_type[K];
+	auto recoded = new code_type[N];
+	PolarEncoder<code_type, M> encode;
+	PolarSysEnc<code_type, M> sysenc;
+	auto program = new uint8_t[N];
+	PolarCompiler compile;
+	int length = compile(program, frozen, M);
+	std::cerr << "program length = " << length << std::endl;
+	std::cerr << "sizeof(PolarListDecoder<code_type, M, L>) = " << sizeof(PolarListDecoder<code_type, M, L>) << std::endl;
+	auto decode = new PolarListDecoder<code_type, M, L>;
+	CRC<uint16_t> crc(0x8408);
+	auto check = [&](const code_type *mesg) {
+		crc.reset();
+		if (systematic) {
+			encode(recoded, mesg, frozen);
+			for (int i = 0; i < N; ++i)
+				if (!frozen[i])
+					crc(recoded[i] < 0);
+		} else {
+			for (int i = 0; i < K; ++i)
+				crc(mesg[i] < 0);
+		}
+		return !crc();
+	};
+
+	auto orig = new code_type[N];
+	auto noisy = new code_type[N];
+	auto symb = new double[N];
+	double low_SNR = std::floor(design_SNR-3);
+	double high_SNR = std::ceil(design_SNR+5);
+	double min_SNR = high_SNR, max_mbs = 0;
+	int count = 0;
+	std::cerr << "SNR BER FER Mbit/s Eb/N0" << std::endl;
+	for (double SNR = low_SNR; count <= 3 && SNR <= high_SNR; SNR += 0.1, ++count) {
+		//double mean_signal = 0;
+		double sigma_signal = 1;
+		double mean_noise = 0;
+		double sigma_noise = std::sqrt(sigma_signal * sigma_signal / (2 * std::pow(10, SNR / 10)));
+
+		typedef std::normal_distribution<double> normal;
+		auto awgn = std::bind(normal(mean_noise, sigma_noise), generator(rd()));
+
+		int64_t uncorrected_errors = 0;
+		int64_t frame_errors = 0;
+		double avg_mbs = 0;
+		int64_t loops = 0;
+		while (uncorrected_errors < 1000 && ++loops < 100) {
+			crc.reset();
+			for (int i = 0; i < K - C; ++i)
+				crc((message[i] = 1 - 2 * data()) < 0);
+			for (int i = 0, parity = crc(); i < C; ++i)
+				message[K-C+i] = 1 - 2 * ((parity >> i) & 1);
+
+			if (systematic)
+				sysenc(codeword, message, frozen);
+			else
+				encode(codeword, message, frozen);
+
+			for (int i = 0; i < N; ++i)
+				orig[i] = codeword[i];
+
+			for (int i = 0; i < N; ++i)
+				symb[i] = codeword[i];
+
+			for (int i = 0; i < N; ++i)
+				symb[i] += awgn();
+
+			// $LLR=log(\frac{p(x=+1|y)}{p(x=-1|y)})$
+			// $p(x|\mu,\sigma)=\frac{1}{\sqrt{2\pi}\sigma}}e^{-\frac{(x-\mu)^2}{2\sigma^2}}$
+			double DIST = 2; // BPSK
+			double fact = DIST / (sigma_noise * sigma_noise);
+			for (int i = 0; i < N; ++i)
+				codeword[i] = PolarHelper<code_type>::quant(fact * symb[i]);
+
+			for (int i = 0; i < N; ++i)
+				noisy[i] = codeword[i];
+
+			auto start = std::chrono::system_clock::now();
+			(*decode)(decoded, codeword, program, L, check);
+			auto end = std::chrono::system_clock::now();
+			auto usec = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+			double mbs = (double)K / usec.count();
+			avg_mbs += mbs;
+
+			if (systematic) {
+				encode(codeword, decoded, frozen);
+				for (int i = 0, j = 0; i < N; ++i)
+					if (!frozen[i])
+						decoded[j++] = codeword[i];
+			}
+
+			int errors = 0;
+			for (int i = 0; i < K; ++i)
+				errors += decoded[i] * message[i] <= 0;
+			uncorrected_errors += errors;
+			frame_errors += !!errors;
+		}
+
+		avg_mbs /= loops;
+		max_mbs = std::max(max_mbs, avg_mbs);
+		double bit_error_rate = (double)uncorrected_errors / (double)(K * loops);
+		double frame_error_rate = (double)frame_errors / (double)loops;
+		if (!uncorrected_errors)
+			min_SNR = std::min(min_SNR, SNR);
+		else
+			count = 0;
+
+		int MOD_BITS = 1; // BPSK
+		double code_rate = (double)(K - C) / (double)N;
+		double spectral_efficiency = code_rate * MOD_BITS;
+		double EbN0 = 10 * std::log10(sigma_signal * sigma_signal / (spectral_efficiency * 2 * sigma_noise * sigma_noise));
+
+		std::cout << SNR << " " << bit_error_rate << " " << frame_error_rate << " " << avg_mbs << " " << EbN0 << std::endl;
+	}
+	std::cerr << "QEF at: " << min_SNR << " SNR, speed: " << max_mbs << " Mb/s." << std::endl;
+	return 0;
+}
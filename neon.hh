@@ -459,6 +459,14 @@ inline SIMD<int8_t, 16> vmul(SIMD<int8_t, 16> a, SIMD<int8_t, 16> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 8> vmul(SIMD<int16_t, 8> a, SIMD<int16_t, 8> b)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = vmulq_s16(a.m, b.m);
+	return tmp;
+}
+
 template <>
 inline SIMD<float, 4> vabs(SIMD<float, 4> a)
 {
@@ -502,6 +510,15 @@ inline SIMD<int8_t, 16> vsignum(SIMD<int8_t, 16> a)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 8> vsignum(SIMD<int16_t, 8> a)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = (int16x8_t)vorrq_u16(vcgtq_s16(vdupq_n_s16(0), a.m),
+		vandq_u16(vcgtq_s16(a.m, vdupq_n_s16(0)), (uint16x8_t)vdupq_n_s16(1)));
+	return tmp;
+}
+
 template <>
 inline SIMD<float, 4> vsign(SIMD<float, 4> a, SIMD<float, 4> b)
 {
@@ -522,6 +539,16 @@ inline SIMD<int8_t, 16> vsign(SIMD<int8_t, 16> a, SIMD<int8_t, 16> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 8> vsign(SIMD<int16_t, 8> a, SIMD<int16_t, 8> b)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = (int16x8_t)vorrq_u16(
+		vandq_u16(vcgtq_s16(vdupq_n_s16(0), b.m), (uint16x8_t)vnegq_s16(a.m)),
+		vandq_u16(vcgtq_s16(b.m, vdupq_n_s16(0)), (uint16x8_t)a.m));
+	return tmp;
+}
+
 template <>
 inline SIMD<float, 4> vcopysign(SIMD<float, 4> a, SIMD<float, 4> b)
 {
@@ -979,3 +1006,52 @@ inline SIMD<int8_t, 16> vshuf(SIMD<int8_t, 16> a, SIMD<uint8_t, 16> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 8> vshr(SIMD<int16_t, 8> a, int n)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = vshlq_s16(a.m, vdupq_n_s16(-n));
+	return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 16> vqmovn(SIMD<int16_t, 8> a, SIMD<int16_t, 8> b)
+{
+	SIMD<int8_t, 16> tmp;
+	tmp.m = vcombine_s8(vqmovn_s16(a.m), vqmovn_s16(b.m));
+	return tmp;
+}
+
+template <>
+inline SIMD<int16_t, 8> vmovl_low(SIMD<int8_t, 16> a)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = vmovl_s8(vget_low_s8(a.m));
+	return tmp;
+}
+
+template <>
+inline SIMD<int16_t, 8> vmovl_high(SIMD<int8_t, 16> a)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = vmovl_s8(vget_high_s8(a.m));
+	return tmp;
+}
+
+#if defined(__aarch64__) || (defined(__ARM_FP) && (__ARM_FP & 2))
+template <>
+inline SIMD<float, 4> vcvt_float(SIMD<uint16_t, 4> a)
+{
+	SIMD<float, 4> tmp;
+	tmp.m = vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(a.v)));
+	return tmp;
+}
+
+template <>
+inline SIMD<uint16_t, 4> vcvt_half(SIMD<float, 4> a)
+{
+	SIMD<uint16_t, 4> tmp;
+	vst1_u16(tmp.v, vreinterpret_u16_f16(vcvt_f16_f32(a.m)));
+	return tmp;
+}
+#endif
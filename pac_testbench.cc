@@ -0,0 +1,108 @@
+/*
+Test bench for list and Fano decoding of polarization-adjusted convolutional codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+#include "polar_pac_decoder.hh"
+
+int main()
+{
+	const int M = 7;
+	const int N = 1 << M;
+	const int L = 32;
+	const int LIMIT = 100000;
+	typedef float code_type;
+	typedef std::default_random_engine generator;
+	typedef std::uniform_int_distribution<int> distribution;
+	auto data = std::bind(distribution(0, 1), generator(1));
+	auto frozen = new uint8_t[N];
+	auto codeword = new code_type[N];
+
+	long double erasure_probability = 0.5;
+	int K = (1 - erasure_probability) * N;
+	double design_SNR = 10 * std::log10(-std::log(erasure_probability));
+	{
+		auto freeze = new PolarRMProfile<M>;
+		long double probability = std::exp(-pow(10.0, (design_SNR + 1.59175) / 10));
+		(*freeze)(frozen, M, K, probability);
+		delete freeze;
+	}
+	std::cerr << "PAC(" << N << ", " << K << ") with list size up to " << L << " and Fano limit " << LIMIT << std::endl;
+	auto message = new code_type[K];
+	auto decoded = new code_type[K];
+	PolarPACEnc<code_type, M> encode;
+	auto list = new PolarPACListDecoder<code_type, M, L>;
+	auto fano = new PolarPACFanoDecoder<code_type, M>;
+	const int D = 4;
+	const int lists[D-1] = { 1, 4, L };
+
+	auto symb = new double[N];
+	std::cerr << "SNR FER(L=1) FER(L=4) FER(L=" << L << ") FER(Fano) Mbit/s(L=1) Mbit/s(L=4) Mbit/s(L=" << L << ") Mbit/s(Fano) steps/frame" << std::endl;
+	for (double SNR = -1; SNR <= 0.5; SNR += 0.5) {
+		double sigma_signal = 1;
+		double mean_noise = 0;
+		double sigma_noise = std::sqrt(sigma_signal * sigma_signal / (2 * std::pow(10, SNR / 10)));
+
+		typedef std::normal_distribution<double> normal;
+		auto awgn = std::bind(normal(mean_noise, sigma_noise), generator(2));
+
+		int64_t frame_errors[D] = { 0 };
+		double usec[D] = { 0 };
+		int64_t steps = 0;
+		int64_t loops = 5000;
+		long double probability = std::exp(-pow(10.0, SNR / 10));
+		for (int64_t loop = 0; loop < loops; ++loop) {
+			for (int i = 0; i < K; ++i)
+				message[i] = 1 - 2 * data();
+			encode(codeword, message, frozen);
+
+			for (int i = 0; i < N; ++i)
+				symb[i] = codeword[i] + awgn();
+
+			double DIST = 2; // BPSK
+			double fact = DIST / (sigma_noise * sigma_noise);
+			for (int i = 0; i < N; ++i)
+				codeword[i] = PolarHelper<code_type>::quant(fact * symb[i]);
+
+			for (int d = 0; d < D; ++d) {
+				auto start = std::chrono::system_clock::now();
+				if (d == D - 1) {
+					int used = (*fano)(decoded, codeword, frozen, M, LIMIT, 1, probability);
+					steps += used < 0 ? LIMIT : used;
+				} else {
+					(*list)(decoded, codeword, frozen, M, lists[d]);
+				}
+				auto end = std::chrono::system_clock::now();
+				usec[d] += std::chrono::duration<double, std::micro>(end - start).count();
+				int errors = 0;
+				for (int i = 0; i < K; ++i)
+					errors += decoded[i] * message[i] <= 0;
+				frame_errors[d] += !!errors;
+			}
+		}
+
+		std::cout << SNR;
+		for (int d = 0; d < D; ++d)
+			std::cout << " " << (double)frame_errors[d] / (double)loops;
+		for (int d = 0; d < D; ++d)
+			std::cout << " " << (double)(loops * K) / usec[d];
+		std::cout << " " << (double)steps / (double)loops << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+Adaptive successive cancellation list decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int MAX_L = 32>
+class PolarAdaptiveDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::value_type VALUE;
+	static const int MAX_N = 1 << MAX_M;
+	static const int WIDTH = PH::SIZE;
+	PolarDecoder<TYPE, MAX_M> decode;
+	PolarListDecoder<VALUE, MAX_M, MAX_L> list;
+	VALUE chan[MAX_N];
+	VALUE mesg[MAX_N];
+	uint8_t frozen[MAX_N];
+
+	int info(const uint8_t *program)
+	{
+		int count = 0, length = 1 << *program;
+		PolarCompiler::freeze(frozen, program);
+		for (int i = 0; i < length; ++i)
+			count += !frozen[i];
+		return count;
+	}
+public:
+	template <typename CHECK>
+	int operator()(int *result, TYPE *message, const TYPE *codeword, const uint8_t *program, int list_size, CHECK check, uint64_t mask = ~uint64_t(0))
+	{
+		static_assert(WIDTH <= 64, "lanes must fit into mask");
+		assert(list_size >= 1 && list_size <= MAX_L);
+		decode(message, codeword, program, nullptr, mask);
+		int runs = 0, count = 0, length = 1 << *program;
+		for (int k = 0; k < WIDTH; ++k) {
+			result[k] = 0;
+			if (!(mask >> k & 1))
+				continue;
+			result[k] = check(message, k) ? 0 : -1;
+			if (result[k] == 0 || list_size < 2)
+				continue;
+			if (!count)
+				count = info(program);
+			for (int i = 0; i < length; ++i)
+				chan[i] = PH::get(codeword[i], k);
+			auto lane = [&](const VALUE *m) {
+				for (int i = 0; i < count; ++i)
+					PH::set(message+i, k, m[i]);
+				return check(message, k);
+			};
+			for (int l = 1; result[k] < 0 && l < list_size; ++runs) {
+				l = std::min(2 * l, list_size);
+				if (list(mesg, chan, program, l, lane) >= 0)
+					result[k] = l;
+			}
+			if (result[k] < 0)
+				for (int i = 0; i < count; ++i)
+					PH::set(message+i, k, mesg[i]);
+		}
+		return runs;
+	}
+};
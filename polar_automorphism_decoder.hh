@@ -0,0 +1,166 @@
+/*
+Automorphism ensemble decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int PERIOD = 5>
+class PolarAutomorphismDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::value_type VALUE;
+	typedef typename PH::PATH PATH;
+	static const int MAX_N = 1 << MAX_M;
+	static const int WIDTH = PH::SIZE;
+	PolarDecoder<TYPE, MAX_M, PERIOD> decode;
+	TYPE chan[MAX_N];
+	TYPE mesg[MAX_N];
+	TYPE code[MAX_N];
+	VALUE temp[MAX_N];
+	int8_t bits[2][MAX_N];
+	uint8_t known[MAX_N];
+	int perm[WIDTH][MAX_N];
+	int level;
+	uint32_t seed;
+
+	uint32_t rand()
+	{
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return seed;
+	}
+	// the image of every unit message, dynamic frozen bits included, must be a codeword again
+	bool invariant(const int *map, const uint8_t *frozen, int lvl)
+	{
+		int length = 1 << lvl;
+		for (int i = 0; i < length; ++i) {
+			if (frozen[i])
+				continue;
+			for (int j = 0; j < length; ++j)
+				bits[0][j] = j == i || (j > i && frozen[j] == 2 && j % PERIOD == i % PERIOD) ? -1 : 1;
+			polar_trans(bits[0], bits[0], length);
+			for (int j = 0; j < length; ++j)
+				bits[1][j] = bits[0][map[j]];
+			polar_trans(bits[1], bits[1], length);
+			int8_t parity[PERIOD];
+			for (int j = 0; j < PERIOD; ++j)
+				parity[j] = 1;
+			for (int j = 0; j < length; ++j) {
+				if (!frozen[j])
+					parity[j%PERIOD] *= bits[1][j];
+				else if (bits[1][j] != (frozen[j] == 2 ? parity[j%PERIOD] : 1))
+					return false;
+			}
+		}
+		return true;
+	}
+	// SC already absorbs maps that only feed an index bit into higher bits.
+	// feeding bit c into a lower bit r is an automorphism only if moving a zero from c to r keeps every information index.
+	bool movable(const uint8_t *frozen, int lvl, int r, int c)
+	{
+		int length = 1 << lvl;
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i] && !(i >> r & 1) && frozen[(i | 1 << r) & ~(1 << c)])
+				return false;
+		return true;
+	}
+	// flipping bit b of the index is an automorphism only if setting it keeps every information index.
+	bool settable(const uint8_t *frozen, int lvl, int b)
+	{
+		int length = 1 << lvl;
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i] && frozen[i | 1 << b])
+				return false;
+		return true;
+	}
+	void generate(int lvl, const uint8_t *frozen)
+	{
+		int length = 1 << lvl;
+		bool dynamic = false;
+		for (int i = 0; i < length; ++i)
+			dynamic |= (known[i] = frozen[i]) == 2;
+		int rows[MAX_M*MAX_M], cols[MAX_M*MAX_M], moves = 0, mask = 0;
+		for (int c = 1; c < lvl; ++c) {
+			for (int r = 0; r < c; ++r) {
+				if (movable(frozen, lvl, r, c)) {
+					rows[moves] = r;
+					cols[moves] = c;
+					++moves;
+				}
+			}
+		}
+		for (int b = 0; b < lvl; ++b)
+			if (settable(frozen, lvl, b))
+				mask |= 1 << b;
+		for (int i = 0; i < length; ++i)
+			perm[0][i] = i;
+		for (int k = 1; k < WIDTH; ++k) {
+			for (int i = 0; i < length; ++i)
+				perm[k][i] = i;
+			for (int n = 0; moves && n < 2 * lvl; ++n) {
+				int t = rand() % moves, r = rows[t], c = cols[t];
+				for (int i = 0; i < length; ++i)
+					perm[k][i] ^= (perm[k][i] >> c & 1) << r;
+			}
+			int off = rand() & mask;
+			for (int i = 0; i < length; ++i)
+				perm[k][i] ^= off;
+			if (dynamic && !invariant(perm[k], frozen, lvl))
+				for (int i = 0; i < length; ++i)
+					perm[k][i] = i;
+		}
+		level = lvl;
+	}
+public:
+	PolarAutomorphismDecoder(uint32_t seed = 2463534242) : level(-1), seed(seed)
+	{
+	}
+	int operator()(VALUE *message, const VALUE *codeword, const uint8_t *program, const uint8_t *frozen)
+	{
+		int length = 1 << *program;
+		assert(*program <= MAX_M);
+		bool same = *program == level;
+		for (int i = 0; same && i < length; ++i)
+			same = known[i] == frozen[i];
+		if (!same)
+			generate(*program, frozen);
+		for (int i = 0; i < length; ++i)
+			for (int k = 0; k < WIDTH; ++k)
+				PH::set(chan+i, k, codeword[perm[k][i]]);
+		decode(mesg, chan, program);
+		TYPE parity[PERIOD];
+		for (int i = 0; i < PERIOD; ++i)
+			parity[i] = PH::one();
+		for (int i = 0, j = 0; i < length; ++i) {
+			if (!frozen[i])
+				parity[i%PERIOD] = PH::qmul(parity[i%PERIOD], code[i] = PH::decide(mesg[j++]));
+			else
+				code[i] = frozen[i] == 2 ? parity[i%PERIOD] : PH::one();
+		}
+		polar_trans(code, code, length);
+		int best = 0;
+		PATH least = 0;
+		for (int k = 0; k < WIDTH; ++k) {
+			PATH pen = 0;
+			for (int i = 0; i < length; ++i) {
+				VALUE sft = PH::get(chan[i], k);
+				if ((sft < 0) != (PH::get(code[i], k) < 0))
+					pen += std::abs(sft);
+			}
+			if (!k || pen < least) {
+				least = pen;
+				best = k;
+			}
+		}
+		for (int i = 0; i < length; ++i)
+			temp[perm[best][i]] = PH::get(code[i], best);
+		polar_trans(temp, temp, length);
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i])
+				*message++ = temp[i];
+		return best;
+	}
+};
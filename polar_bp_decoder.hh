@@ -0,0 +1,122 @@
+/*
+Belief propagation decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M>
+class PolarBPDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::value_type VALUE;
+	static const int MAX_N = 1 << MAX_M;
+	static const int WIDTH = PH::SIZE;
+	TYPE lsoft[MAX_M*MAX_N];
+	TYPE rsoft[(MAX_M+1)*MAX_N];
+	TYPE hard[MAX_N];
+
+	static VALUE certain()
+	{
+		if (std::is_floating_point<VALUE>::value)
+			return 1 << 16;
+		return std::numeric_limits<VALUE>::max();
+	}
+	static void left(TYPE *out, const TYPE *inp, const TYPE *rgt, int h, int length)
+	{
+		for (int i = 0; i < length; i += 2 * h) {
+			for (int j = i; j < i + h; ++j) {
+				out[j] = PH::prod(inp[j], PH::qadd(inp[j+h], rgt[j+h]));
+				out[j+h] = PH::qadd(PH::prod(inp[j], rgt[j]), inp[j+h]);
+			}
+		}
+	}
+	static void right(TYPE *out, const TYPE *inp, const TYPE *lft, int h, int length)
+	{
+		for (int i = 0; i < length; i += 2 * h) {
+			for (int j = i; j < i + h; ++j) {
+				out[j] = PH::prod(inp[j], PH::qadd(lft[j+h], inp[j+h]));
+				out[j+h] = PH::qadd(PH::prod(inp[j], lft[j]), inp[j+h]);
+			}
+		}
+	}
+	void estimate(const TYPE *codeword, int level)
+	{
+		int length = 1 << level;
+		const TYPE *rgt = rsoft + level * MAX_N;
+		for (int i = 0; i < length; ++i)
+			hard[i] = PH::decide(PH::qadd(codeword[i], rgt[i]));
+		polar_trans(hard, hard, length);
+	}
+	void lane(TYPE *message, const uint8_t *frozen, int length, int k)
+	{
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i])
+				PH::set(message++, k, PH::get(hard[i], k));
+	}
+	uint64_t converged(int *result, TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, uint64_t pending, int iter)
+	{
+		int length = 1 << level;
+		estimate(codeword, level);
+		TYPE okay = PH::one();
+		for (int i = 0; i < length; ++i)
+			if (frozen[i])
+				okay = PH::qmin(okay, hard[i]);
+		for (int k = 0; k < WIDTH; ++k) {
+			if (pending >> k & 1 && PH::get(okay, k) >= 0) {
+				result[k] = iter;
+				pending &= ~(uint64_t(1) << k);
+				lane(message, frozen, length, k);
+			}
+		}
+		return pending;
+	}
+public:
+	int operator()(int *result, TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, int iterations, uint64_t mask = ~uint64_t(0))
+	{
+		static_assert(WIDTH <= 64, "lanes must fit into mask");
+		assert(level >= 1 && level <= MAX_M);
+		assert(iterations >= 1);
+		int length = 1 << level;
+		uint64_t active = mask & (~uint64_t(0) >> (64 - WIDTH)), pending = active;
+		for (int k = 0; k < WIDTH; ++k)
+			result[k] = pending >> k & 1 ? -1 : 0;
+		TYPE prior;
+		for (int k = 0; k < WIDTH; ++k)
+			PH::set(&prior, k, certain());
+		for (int i = 0; i < length; ++i) {
+			assert(frozen[i] < 2);
+			rsoft[i] = frozen[i] ? prior : PH::zero();
+		}
+		for (int s = 1; s <= level; ++s)
+			for (int i = 0; i < length; ++i)
+				rsoft[s*MAX_N+i] = PH::zero();
+		int iter = 0;
+		while (pending && iter < iterations) {
+			++iter;
+			const TYPE *inp = codeword;
+			for (int s = level-1; s > 0; --s) {
+				left(lsoft + s * MAX_N, inp, rsoft + s * MAX_N, 1 << s, length);
+				inp = lsoft + s * MAX_N;
+			}
+			for (int s = 0; s < level; ++s) {
+				const TYPE *lft = s < level - 1 ? lsoft + (s+1) * MAX_N : codeword;
+				right(rsoft + (s+1) * MAX_N, rsoft + s * MAX_N, lft, 1 << s, length);
+			}
+			pending = converged(result, message, codeword, frozen, level, pending, iter);
+		}
+		if (!iter)
+			estimate(codeword, level);
+		if (pending == active) {
+			for (int i = 0; i < length; ++i)
+				if (!frozen[i])
+					*message++ = hard[i];
+		} else {
+			for (int k = 0; k < WIDTH; ++k)
+				if (!((active & ~pending) >> k & 1))
+					lane(message, frozen, length, k);
+		}
+		return iter;
+	}
+};
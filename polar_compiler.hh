@@ -10,51 +10,200 @@ class PolarCompiler
 {
 	static const int left = 0, right = 1, comb = 2,
 		rate0 = 3, rate1 = 4, rep = 5, spc = 6,
-		rate0_right = 7, rate0_comb = 8, rate1_comb = 9;
+		rate0_right = 7, rate0_comb = 8, rate1_comb = 9,
+		grep = 10, grep_spc = 11, gpc = 12, type4 = 13, type5 = 14, pair = 15, masked = 16;
 	static int frozen_count(const uint8_t *frozen, int level)
 	{
 		int count = 0;
 		for (int i = 0; i < (1<<level); ++i)
-			count += frozen[i];
+			count += !!frozen[i];
 		return count;
 	}
-	static void compile(uint8_t **program, const uint8_t *frozen, int level)
+	static bool dynamic(const uint8_t *frozen, int level)
 	{
+		for (int i = 0; i < (1<<level); ++i)
+			if (frozen[i] == 2)
+				return true;
+		return false;
+	}
+	static bool uniform(const uint8_t *frozen, int first, int last, int value)
+	{
+		for (int i = first; i < last; ++i)
+			if (frozen[i] != value)
+				return false;
+		return true;
+	}
+	static int special(const uint8_t *frozen, int level, int *operand)
+	{
+		int length = 1 << level;
+		for (int r = 1; r < level; ++r) {
+			int inner = 1 << r;
+			*operand = r;
+			if (uniform(frozen, 0, length-inner, 1) && uniform(frozen, length-inner, length, 0))
+				return grep;
+			if (r > 1 && uniform(frozen, 0, length-inner+1, 1) && uniform(frozen, length-inner+1, length, 0))
+				return grep_spc;
+			if (r < level-1 && uniform(frozen, 0, inner, 1) && uniform(frozen, inner, length, 0))
+				return gpc;
+		}
+		*operand = -1;
+		if (level < 3)
+			return -1;
+		if (uniform(frozen, 0, 3, 1) && uniform(frozen, 3, length, 0))
+			return type4;
+		if (uniform(frozen, 0, length-5, 1) && !frozen[length-5] && frozen[length-4] && uniform(frozen, length-3, length, 0))
+			return type5;
+		return -1;
+	}
+	static void emit(uint8_t **program, const uint8_t *end, int code)
+	{
+		assert(!end || *program < end);
+		*(*program)++ = code;
+	}
+	static void compile(uint8_t **program, const uint8_t *end, const uint8_t *frozen, int level, bool generalized)
+	{
+		int node, operand;
 		assert(level > 0);
 		int lcnt = frozen_count(frozen, level-1);
 		int rcnt = frozen_count(frozen+(1<<(level-1)), level-1);
-		if (lcnt == 1<<(level-1) && rcnt == 1<<(level-1)) {
-			*(*program)++ = rate0;
+		if (dynamic(frozen, level)) {
+			if (level == 1) {
+				emit(program, end, pair);
+				emit(program, end, frozen[0] | frozen[1] << 2);
+			} else if (uniform(frozen, 0, 1<<(level-1), 1)) {
+				emit(program, end, rate0_right);
+				compile(program, end, frozen+(1<<(level-1)), level-1, generalized);
+				emit(program, end, rate0_comb);
+			} else {
+				emit(program, end, left);
+				compile(program, end, frozen, level-1, generalized);
+				emit(program, end, right);
+				compile(program, end, frozen+(1<<(level-1)), level-1, generalized);
+				emit(program, end, comb);
+			}
+		} else if (lcnt == 1<<(level-1) && rcnt == 1<<(level-1)) {
+			emit(program, end, rate0);
 		} else if (lcnt == 0 && rcnt == 0) {
-			*(*program)++ = rate1;
+			emit(program, end, rate1);
 		} else if (lcnt == 1<<(level-1) && rcnt == (1<<(level-1))-1 && !frozen[(1<<level)-1]) {
-			*(*program)++ = rep;
+			emit(program, end, rep);
 		} else if (lcnt == 1 && rcnt == 0 && frozen[0]) {
-			*(*program)++ = spc;
+			emit(program, end, spc);
+		} else if (generalized && (node = special(frozen, level, &operand)) >= 0) {
+			emit(program, end, node);
+			if (operand >= 0)
+				emit(program, end, operand);
 		} else if (lcnt == 1<<(level-1)) {
-			*(*program)++ = rate0_right;
-			compile(program, frozen+(1<<(level-1)), level-1);
-			*(*program)++ = rate0_comb;
+			emit(program, end, rate0_right);
+			compile(program, end, frozen+(1<<(level-1)), level-1, generalized);
+			emit(program, end, rate0_comb);
 		} else if (rcnt == 0) {
-			*(*program)++ = left;
-			compile(program, frozen, level-1);
-			*(*program)++ = rate1_comb;
+			emit(program, end, left);
+			compile(program, end, frozen, level-1, generalized);
+			emit(program, end, rate1_comb);
+		} else {
+			emit(program, end, left);
+			compile(program, end, frozen, level-1, generalized);
+			emit(program, end, right);
+			compile(program, end, frozen+(1<<(level-1)), level-1, generalized);
+			emit(program, end, comb);
+		}
+	}
+	static bool agree(const uint8_t *const *frozen, int lanes, int first, int last)
+	{
+		for (int k = 1; k < lanes; ++k)
+			for (int i = first; i < last; ++i)
+				if (frozen[k][i] != frozen[0][i])
+					return false;
+		return true;
+	}
+	static void compile(uint8_t **program, const uint8_t *end, const uint8_t *const *frozen, int lanes, int offset, int level)
+	{
+		int length = 1 << level;
+		if (agree(frozen, lanes, offset, offset+length)) {
+			compile(program, end, frozen[0]+offset, level, false);
+		} else if (level == 1) {
+			int used = 0;
+			for (int k = 0; k < lanes; ++k)
+				used |= (!frozen[k][offset]) | (!frozen[k][offset+1]) << 1;
+			emit(program, end, masked);
+			emit(program, end, used);
 		} else {
-			*(*program)++ = left;
-			compile(program, frozen, level-1);
-			*(*program)++ = right;
-			compile(program, frozen+(1<<(level-1)), level-1);
-			*(*program)++ = comb;
+			emit(program, end, left);
+			compile(program, end, frozen, lanes, offset, level-1);
+			emit(program, end, right);
+			compile(program, end, frozen, lanes, offset+length/2, level-1);
+			emit(program, end, comb);
 		}
 	}
 public:
-	int operator()(uint8_t *program, const uint8_t *frozen, int level)
+	int operator()(uint8_t *program, int capacity, const uint8_t *const *frozen, int lanes, int level)
+	{
+		assert(capacity >= 2);
+		uint8_t *first = program;
+		*program++ = level;
+		compile(&program, first + capacity - 1, frozen, lanes, 0, level);
+		*program++ = 255;
+		return program - first;
+	}
+	int operator()(uint8_t *program, const uint8_t *frozen, int level, bool generalized = false)
 	{
 		uint8_t *first = program;
 		*program++ = level;
-		compile(&program, frozen, level);
+		compile(&program, nullptr, frozen, level, generalized);
 		*program++ = 255;
 		return program - first;
 	}
+	// executes the next instruction, node(op, operand, lvl, off) sees the node it works on:
+	// the parent for left, right, comb and their rate0 and rate1 variants, the leaf otherwise.
+	template <typename NODE>
+	static const uint8_t *step(const uint8_t *program, int &lvl, int &off, NODE node)
+	{
+		int op = *program++, operand = -1;
+		if (op == grep || op == grep_spc || op == gpc || op == pair || op == masked)
+			operand = *program++;
+		switch (op) {
+		case left: node(op, operand, lvl, off); --lvl; break;
+		case right: node(op, operand, lvl+1, off); off += 1 << lvl; break;
+		case comb: off -= 1 << lvl; node(op, operand, ++lvl, off); break;
+		case rate0_right: node(op, operand, lvl--, off); off += 1 << lvl; break;
+		case rate0_comb: off -= 1 << lvl; node(op, operand, ++lvl, off); break;
+		case rate1_comb: node(op, operand, ++lvl, off); break;
+		default: assert(op >= rate0 && op <= masked); node(op, operand, lvl, off);
+		}
+		return program;
+	}
+	template <typename NODE>
+	static void walk(const uint8_t *program, NODE node)
+	{
+		int level = *program++, lvl = level, off = 0;
+		while (*program != 255)
+			program = step(program, lvl, off, node);
+		assert(lvl == level);
+	}
+	// masked nodes only freeze the bits that are frozen in every lane
+	static void freeze(uint8_t *frozen, const uint8_t *program)
+	{
+		walk(program, [frozen](int op, int operand, int lvl, int off) {
+			int length = 1 << lvl, inner = operand >= 0 ? 1 << operand : 0;
+			uint8_t *bits = frozen + off;
+			for (int i = 0; i < length; ++i) {
+				switch (op) {
+				case rate0: bits[i] = 1; break;
+				case rate1: bits[i] = 0; break;
+				case rep: bits[i] = i < length-1; break;
+				case spc: bits[i] = !i; break;
+				case rate0_right: if (i < length/2) bits[i] = 1; break;
+				case rate1_comb: if (i >= length/2) bits[i] = 0; break;
+				case grep: bits[i] = i < length-inner; break;
+				case grep_spc: bits[i] = i < length-inner+1; break;
+				case gpc: bits[i] = i < inner; break;
+				case type4: bits[i] = i < 3; break;
+				case type5: bits[i] = i < length-5 || i == length-4; break;
+				case pair: bits[i] = operand >> 2*i & 3; break;
+				case masked: bits[i] = !(operand >> i & 1); break;
+				}
+			}
+		});
+	}
 };
-
@@ -6,25 +6,13 @@ Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
 
 #pragma once
 
-template <typename TYPE, int MAX_M>
+template <typename TYPE, int MAX_M, int PERIOD = 5>
 class PolarDecoder
 {
+	static_assert(PERIOD >= 1, "parity register needs at least one entry");
 	typedef PolarHelper<TYPE> PH;
 	static const int MAX_N = 1 << MAX_M;
 
-	template <int level>
-	static void trans(TYPE *out, const TYPE *inp)
-	{
-		int length = 1 << level;
-		for (int i = 0; i < length; i += 2) {
-			out[i] = PH::qmul(inp[i], inp[i+1]);
-			out[i+1] = inp[i+1];
-		}
-		for (int h = 2; h < length; h *= 2)
-			for (int i = 0; i < length; i += 2 * h)
-				for (int j = i; j < i + h; ++j)
-					out[j] = PH::qmul(out[j], out[j+h]);
-	}
 	template <int level>
 	static void left(TYPE *soft, TYPE *, TYPE *)
 	{
@@ -80,7 +68,7 @@ class PolarDecoder
 		int length = 1 << (level - 1);
 		for (int i = 0; i < length; ++i)
 			hard[i] = PH::qmul(hard[i], hard[i+length] = PH::signum(PH::madd(hard[i], soft[i+2*length], soft[i+3*length])));
-		trans<level-1>(mesg, hard+length);
+		polar_trans(mesg, hard+length, length);
 	}
 	template <int level>
 	static void rate1(TYPE *soft, TYPE *hard, TYPE *mesg)
@@ -89,7 +77,7 @@ class PolarDecoder
 		int length = 1 << level;
 		for (int i = 0; i < length; ++i)
 			hard[i] = PH::signum(soft[i+length]);
-		trans<level>(mesg, hard);
+		polar_trans(mesg, hard, 1 << level);
 	}
 	template <int level>
 	static void rep(TYPE *soft, TYPE *hard, TYPE *mesg)
@@ -121,21 +109,199 @@ class PolarDecoder
 			weak = PH::qmin(weak, soft[i]);
 		for (int i = 0; i < length; ++i)
 			hard[i] = PH::flip(hard[i], parity, weak, soft[i]);
-		trans<level>(soft, hard);
+		polar_trans(soft, hard, 1 << level);
 		for (int i = 0; i < length-1; ++i)
 			mesg[i] = soft[i+1];
 	}
-	TYPE soft[2*MAX_N];
-	TYPE hard[MAX_N];
-public:
-	void operator()(TYPE *message, const TYPE *codeword, const uint8_t *program)
+	static void fold(TYPE *soft, int length, int inner)
+	{
+		for (int h = length; h > inner; h /= 2)
+			for (int i = 0; i < h/2; ++i)
+				soft[i+h/2] = PH::qadd(soft[i+h], soft[i+h/2+h]);
+	}
+	static void tile(TYPE *hard, int length, int inner)
+	{
+		for (int i = inner; i < length; ++i)
+			hard[i] = hard[i-inner];
+	}
+	template <int level>
+	static void grep(TYPE *soft, TYPE *hard, TYPE *mesg, int r)
+	{
+		assert(level <= MAX_M);
+		int length = 1 << level, inner = 1 << r;
+		fold(soft, length, inner);
+		for (int i = 0; i < inner; ++i)
+			hard[i] = PH::signum(soft[i+inner]);
+		polar_trans(mesg, hard, inner);
+		tile(hard, length, inner);
+	}
+	template <int level>
+	static void grep_spc(TYPE *soft, TYPE *hard, TYPE *mesg, int r)
 	{
-		TYPE *sft = soft, *hrd = hard, *msg = message;
-		int level = *program++, lvl = level, length = 1 << level;
 		assert(level <= MAX_M);
+		int length = 1 << level, inner = 1 << r;
+		fold(soft, length, inner);
+		for (int i = 0; i < inner; ++i)
+			hard[i] = PH::decide(soft[i+inner]);
+		TYPE parity = hard[0];
+		for (int i = 1; i < inner; ++i)
+			parity = PH::qmul(parity, hard[i]);
+		for (int i = 0; i < inner; ++i)
+			soft[i] = PH::qabs(soft[i+inner]);
+		TYPE weak = soft[0];
+		for (int i = 1; i < inner; ++i)
+			weak = PH::qmin(weak, soft[i]);
+		for (int i = 0; i < inner; ++i)
+			hard[i] = PH::flip(hard[i], parity, weak, soft[i]);
+		polar_trans(soft, hard, inner);
+		for (int i = 0; i < inner-1; ++i)
+			mesg[i] = soft[i+1];
+		tile(hard, length, inner);
+	}
+	template <int level>
+	static void gpc(TYPE *soft, TYPE *hard, TYPE *mesg, int r)
+	{
+		assert(level <= MAX_M);
+		int length = 1 << level, inner = 1 << r;
 		for (int i = 0; i < length; ++i)
-			soft[i+length] = codeword[i];
-		while (*program != 255) {
+			hard[i] = PH::decide(soft[i+length]);
+		for (int i = 0; i < length; ++i)
+			soft[i] = PH::qabs(soft[i+length]);
+		for (int j = 0; j < inner; ++j) {
+			TYPE parity = hard[j], weak = soft[j];
+			for (int i = j+inner; i < length; i += inner) {
+				parity = PH::qmul(parity, hard[i]);
+				weak = PH::qmin(weak, soft[i]);
+			}
+			for (int i = j; i < length; i += inner)
+				hard[i] = PH::flip(hard[i], parity, weak, soft[i]);
+		}
+		polar_trans(soft, hard, 1 << level);
+		for (int i = 0; i < length-inner; ++i)
+			mesg[i] = soft[i+inner];
+	}
+	template <int level>
+	static void type4(TYPE *soft, TYPE *hard, TYPE *mesg)
+	{
+		assert(level <= MAX_M);
+		int length = 1 << level;
+		for (int i = 0; i < length; ++i)
+			hard[i] = PH::decide(soft[i+length]);
+		for (int i = 0; i < length; ++i)
+			soft[i] = PH::qabs(soft[i+length]);
+		TYPE parity[4], weak[4];
+		TYPE even = PH::zero(), odd = PH::zero();
+		for (int j = 0; j < 4; ++j) {
+			parity[j] = hard[j];
+			weak[j] = soft[j];
+			for (int i = j+4; i < length; i += 4) {
+				parity[j] = PH::qmul(parity[j], hard[i]);
+				weak[j] = PH::qmin(weak[j], soft[i]);
+			}
+			even = PH::qadd(even, PH::flip(weak[j], PH::zero(), parity[j], PH::one()));
+			odd = PH::qadd(odd, PH::flip(weak[j], PH::zero(), parity[j], PH::minus()));
+		}
+		TYPE target = PH::flip(PH::minus(), PH::minus(), PH::qmin(even, odd), even);
+		for (int j = 0; j < 4; ++j)
+			parity[j] = PH::qmul(parity[j], target);
+		for (int i = 0; i < length; ++i)
+			hard[i] = PH::flip(hard[i], parity[i&3], weak[i&3], soft[i]);
+		polar_trans(soft, hard, 1 << level);
+		for (int i = 0; i < length-3; ++i)
+			mesg[i] = soft[i+3];
+	}
+	template <int level>
+	static void type5(TYPE *soft, TYPE *hard, TYPE *mesg)
+	{
+		assert(level <= MAX_M);
+		int length = 1 << level;
+		fold(soft, length, 8);
+		const TYPE *sum = soft + 8;
+		TYPE sign[2] = { PH::one(), PH::minus() }, code[2][4], pen[2];
+		for (int k = 0; k < 2; ++k) {
+			TYPE temp[4];
+			for (int i = 0; i < 4; ++i)
+				temp[i] = PH::madd(sign[k], sum[i], sum[i+4]);
+			TYPE parity = PH::one(), weak = PH::qabs(temp[0]);
+			for (int i = 0; i < 4; ++i) {
+				code[k][i] = PH::decide(temp[i]);
+				parity = PH::qmul(parity, code[k][i]);
+				weak = PH::qmin(weak, PH::qabs(temp[i]));
+			}
+			pen[k] = PH::zero();
+			for (int i = 0; i < 4; ++i) {
+				code[k][i] = PH::flip(code[k][i], parity, weak, PH::qabs(temp[i]));
+				pen[k] = PH::qadd(pen[k], PH::flip(PH::qabs(sum[i]), PH::zero(), PH::qmul(sign[k], code[k][i]), PH::decide(sum[i])));
+				pen[k] = PH::qadd(pen[k], PH::flip(PH::qabs(sum[i+4]), PH::zero(), code[k][i], PH::decide(sum[i+4])));
+			}
+		}
+		TYPE best = PH::qmin(pen[0], pen[1]);
+		TYPE first = PH::flip(PH::minus(), PH::minus(), best, pen[0]);
+		for (int i = 0; i < 4; ++i) {
+			hard[i+4] = PH::flip(code[1][i], PH::qmul(code[1][i], code[0][i]), best, pen[0]);
+			hard[i] = PH::qmul(first, hard[i+4]);
+		}
+		polar_trans(soft, hard, 8);
+		mesg[0] = soft[3];
+		mesg[1] = soft[5];
+		mesg[2] = soft[6];
+		mesg[3] = soft[7];
+		tile(hard, length, 8);
+	}
+	static void masked(TYPE *soft, TYPE *hard, TYPE *mesg, const TYPE *frozen, int used)
+	{
+		assert(frozen);
+		TYPE u0 = PH::freeze(PH::decide(PH::prod(soft[2], soft[3])), frozen[0]);
+		TYPE u1 = PH::freeze(PH::decide(PH::madd(u0, soft[2], soft[3])), frozen[1]);
+		hard[0] = PH::qmul(u0, u1);
+		hard[1] = u1;
+		if (used & 1)
+			*mesg++ = u0;
+		if (used & 2)
+			*mesg = u1;
+	}
+	// dynamic frozen bits repeat the parity of the earlier information bits with the same index modulo PERIOD.
+	// the register catches up lazily with the messages decided since the last pair node.
+	void pair(TYPE *soft, TYPE *hard, TYPE *&mesg, int pos, int pattern)
+	{
+		if (!mapped) {
+			PolarCompiler::freeze(fixed, start);
+			mapped = true;
+		}
+		for (; known < pos; ++known)
+			if (!fixed[known])
+				parity[known%PERIOD] = PH::qmul(parity[known%PERIOD], base[used++]);
+		TYPE u[2];
+		for (int i = 0; i < 2; ++i) {
+			TYPE *reg = parity + (pos + i) % PERIOD;
+			switch (pattern >> 2*i & 3) {
+			case 0:
+				u[i] = *mesg++ = PH::decide(i ? PH::madd(u[0], soft[2], soft[3]) : PH::prod(soft[2], soft[3]));
+				*reg = PH::qmul(*reg, u[i]);
+				++used;
+				break;
+			case 1: u[i] = PH::one(); break;
+			default: u[i] = *reg;
+			}
+		}
+		known = pos + 2;
+		hard[0] = PH::qmul(u[0], u[1]);
+		hard[1] = u[1];
+	}
+	TYPE soft[2*MAX_N];
+	TYPE hard[MAX_N];
+	TYPE parity[PERIOD];
+	uint8_t fixed[MAX_N];
+	const uint8_t *start;
+	const TYPE *base;
+	int origin, known, used;
+	bool mapped;
+
+	const uint8_t *decode(TYPE *&msg, const uint8_t *program, int level, const TYPE *frozen)
+	{
+		TYPE *sft = soft, *hrd = hard;
+		int lvl = level;
+		do {
 			switch (*program++) {
 			case 0:	switch (lvl--) {
 				case 2: left<2>(sft, hrd, msg); break;
@@ -457,10 +623,655 @@ public:
 				case 30: rate1_comb<30>(sft, hrd, msg); break;
 				default: assert(false);
 				} msg += 1<<(lvl-1); break;
+			case 10: switch (lvl) {
+				case 2: grep<2>(sft, hrd, msg, *program); break;
+				case 3: grep<3>(sft, hrd, msg, *program); break;
+				case 4: grep<4>(sft, hrd, msg, *program); break;
+				case 5: grep<5>(sft, hrd, msg, *program); break;
+				case 6: grep<6>(sft, hrd, msg, *program); break;
+				case 7: grep<7>(sft, hrd, msg, *program); break;
+				case 8: grep<8>(sft, hrd, msg, *program); break;
+				case 9: grep<9>(sft, hrd, msg, *program); break;
+				case 10: grep<10>(sft, hrd, msg, *program); break;
+				case 11: grep<11>(sft, hrd, msg, *program); break;
+				case 12: grep<12>(sft, hrd, msg, *program); break;
+				case 13: grep<13>(sft, hrd, msg, *program); break;
+				case 14: grep<14>(sft, hrd, msg, *program); break;
+				case 15: grep<15>(sft, hrd, msg, *program); break;
+				case 16: grep<16>(sft, hrd, msg, *program); break;
+				case 17: grep<17>(sft, hrd, msg, *program); break;
+				case 18: grep<18>(sft, hrd, msg, *program); break;
+				case 19: grep<19>(sft, hrd, msg, *program); break;
+				case 20: grep<20>(sft, hrd, msg, *program); break;
+				case 21: grep<21>(sft, hrd, msg, *program); break;
+				case 22: grep<22>(sft, hrd, msg, *program); break;
+				case 23: grep<23>(sft, hrd, msg, *program); break;
+				case 24: grep<24>(sft, hrd, msg, *program); break;
+				case 25: grep<25>(sft, hrd, msg, *program); break;
+				case 26: grep<26>(sft, hrd, msg, *program); break;
+				case 27: grep<27>(sft, hrd, msg, *program); break;
+				case 28: grep<28>(sft, hrd, msg, *program); break;
+				case 29: grep<29>(sft, hrd, msg, *program); break;
+				default: assert(false);
+				} msg += 1<<*program++; break;
+			case 11: switch (lvl) {
+				case 3: grep_spc<3>(sft, hrd, msg, *program); break;
+				case 4: grep_spc<4>(sft, hrd, msg, *program); break;
+				case 5: grep_spc<5>(sft, hrd, msg, *program); break;
+				case 6: grep_spc<6>(sft, hrd, msg, *program); break;
+				case 7: grep_spc<7>(sft, hrd, msg, *program); break;
+				case 8: grep_spc<8>(sft, hrd, msg, *program); break;
+				case 9: grep_spc<9>(sft, hrd, msg, *program); break;
+				case 10: grep_spc<10>(sft, hrd, msg, *program); break;
+				case 11: grep_spc<11>(sft, hrd, msg, *program); break;
+				case 12: grep_spc<12>(sft, hrd, msg, *program); break;
+				case 13: grep_spc<13>(sft, hrd, msg, *program); break;
+				case 14: grep_spc<14>(sft, hrd, msg, *program); break;
+				case 15: grep_spc<15>(sft, hrd, msg, *program); break;
+				case 16: grep_spc<16>(sft, hrd, msg, *program); break;
+				case 17: grep_spc<17>(sft, hrd, msg, *program); break;
+				case 18: grep_spc<18>(sft, hrd, msg, *program); break;
+				case 19: grep_spc<19>(sft, hrd, msg, *program); break;
+				case 20: grep_spc<20>(sft, hrd, msg, *program); break;
+				case 21: grep_spc<21>(sft, hrd, msg, *program); break;
+				case 22: grep_spc<22>(sft, hrd, msg, *program); break;
+				case 23: grep_spc<23>(sft, hrd, msg, *program); break;
+				case 24: grep_spc<24>(sft, hrd, msg, *program); break;
+				case 25: grep_spc<25>(sft, hrd, msg, *program); break;
+				case 26: grep_spc<26>(sft, hrd, msg, *program); break;
+				case 27: grep_spc<27>(sft, hrd, msg, *program); break;
+				case 28: grep_spc<28>(sft, hrd, msg, *program); break;
+				case 29: grep_spc<29>(sft, hrd, msg, *program); break;
+				default: assert(false);
+				} msg += (1<<*program++)-1; break;
+			case 12: switch (lvl) {
+				case 3: gpc<3>(sft, hrd, msg, *program); break;
+				case 4: gpc<4>(sft, hrd, msg, *program); break;
+				case 5: gpc<5>(sft, hrd, msg, *program); break;
+				case 6: gpc<6>(sft, hrd, msg, *program); break;
+				case 7: gpc<7>(sft, hrd, msg, *program); break;
+				case 8: gpc<8>(sft, hrd, msg, *program); break;
+				case 9: gpc<9>(sft, hrd, msg, *program); break;
+				case 10: gpc<10>(sft, hrd, msg, *program); break;
+				case 11: gpc<11>(sft, hrd, msg, *program); break;
+				case 12: gpc<12>(sft, hrd, msg, *program); break;
+				case 13: gpc<13>(sft, hrd, msg, *program); break;
+				case 14: gpc<14>(sft, hrd, msg, *program); break;
+				case 15: gpc<15>(sft, hrd, msg, *program); break;
+				case 16: gpc<16>(sft, hrd, msg, *program); break;
+				case 17: gpc<17>(sft, hrd, msg, *program); break;
+				case 18: gpc<18>(sft, hrd, msg, *program); break;
+				case 19: gpc<19>(sft, hrd, msg, *program); break;
+				case 20: gpc<20>(sft, hrd, msg, *program); break;
+				case 21: gpc<21>(sft, hrd, msg, *program); break;
+				case 22: gpc<22>(sft, hrd, msg, *program); break;
+				case 23: gpc<23>(sft, hrd, msg, *program); break;
+				case 24: gpc<24>(sft, hrd, msg, *program); break;
+				case 25: gpc<25>(sft, hrd, msg, *program); break;
+				case 26: gpc<26>(sft, hrd, msg, *program); break;
+				case 27: gpc<27>(sft, hrd, msg, *program); break;
+				case 28: gpc<28>(sft, hrd, msg, *program); break;
+				case 29: gpc<29>(sft, hrd, msg, *program); break;
+				default: assert(false);
+				} msg += (1<<lvl)-(1<<*program++); break;
+			case 13: switch (lvl) {
+				case 3: type4<3>(sft, hrd, msg); break;
+				case 4: type4<4>(sft, hrd, msg); break;
+				case 5: type4<5>(sft, hrd, msg); break;
+				case 6: type4<6>(sft, hrd, msg); break;
+				case 7: type4<7>(sft, hrd, msg); break;
+				case 8: type4<8>(sft, hrd, msg); break;
+				case 9: type4<9>(sft, hrd, msg); break;
+				case 10: type4<10>(sft, hrd, msg); break;
+				case 11: type4<11>(sft, hrd, msg); break;
+				case 12: type4<12>(sft, hrd, msg); break;
+				case 13: type4<13>(sft, hrd, msg); break;
+				case 14: type4<14>(sft, hrd, msg); break;
+				case 15: type4<15>(sft, hrd, msg); break;
+				case 16: type4<16>(sft, hrd, msg); break;
+				case 17: type4<17>(sft, hrd, msg); break;
+				case 18: type4<18>(sft, hrd, msg); break;
+				case 19: type4<19>(sft, hrd, msg); break;
+				case 20: type4<20>(sft, hrd, msg); break;
+				case 21: type4<21>(sft, hrd, msg); break;
+				case 22: type4<22>(sft, hrd, msg); break;
+				case 23: type4<23>(sft, hrd, msg); break;
+				case 24: type4<24>(sft, hrd, msg); break;
+				case 25: type4<25>(sft, hrd, msg); break;
+				case 26: type4<26>(sft, hrd, msg); break;
+				case 27: type4<27>(sft, hrd, msg); break;
+				case 28: type4<28>(sft, hrd, msg); break;
+				case 29: type4<29>(sft, hrd, msg); break;
+				default: assert(false);
+				} msg += (1<<lvl)-3; break;
+			case 14: switch (lvl) {
+				case 3: type5<3>(sft, hrd, msg); break;
+				case 4: type5<4>(sft, hrd, msg); break;
+				case 5: type5<5>(sft, hrd, msg); break;
+				case 6: type5<6>(sft, hrd, msg); break;
+				case 7: type5<7>(sft, hrd, msg); break;
+				case 8: type5<8>(sft, hrd, msg); break;
+				case 9: type5<9>(sft, hrd, msg); break;
+				case 10: type5<10>(sft, hrd, msg); break;
+				case 11: type5<11>(sft, hrd, msg); break;
+				case 12: type5<12>(sft, hrd, msg); break;
+				case 13: type5<13>(sft, hrd, msg); break;
+				case 14: type5<14>(sft, hrd, msg); break;
+				case 15: type5<15>(sft, hrd, msg); break;
+				case 16: type5<16>(sft, hrd, msg); break;
+				case 17: type5<17>(sft, hrd, msg); break;
+				case 18: type5<18>(sft, hrd, msg); break;
+				case 19: type5<19>(sft, hrd, msg); break;
+				case 20: type5<20>(sft, hrd, msg); break;
+				case 21: type5<21>(sft, hrd, msg); break;
+				case 22: type5<22>(sft, hrd, msg); break;
+				case 23: type5<23>(sft, hrd, msg); break;
+				case 24: type5<24>(sft, hrd, msg); break;
+				case 25: type5<25>(sft, hrd, msg); break;
+				case 26: type5<26>(sft, hrd, msg); break;
+				case 27: type5<27>(sft, hrd, msg); break;
+				case 28: type5<28>(sft, hrd, msg); break;
+				case 29: type5<29>(sft, hrd, msg); break;
+				default: assert(false);
+				} msg += 4; break;
+			case 15: switch (lvl) {
+				case 1: pair(sft, hrd, msg, origin + (hrd - hard), *program++); break;
+				default: assert(false);
+				} break;
+			case 16: switch (lvl) {
+				case 1: masked(sft, hrd, msg, frozen + (hrd - hard), *program); break;
+				default: assert(false);
+				} msg += __builtin_popcount(*program++); break;
 			default: assert(false);
 			}
-		}
-		assert(lvl == level);
+		} while (lvl != level);
+		return program;
+	}
+public:
+	void operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, const TYPE *frozen = nullptr, uint64_t mask = ~uint64_t(0))
+	{
+		static_assert(PH::SIZE <= 64, "lanes must fit into mask");
+		int level = *program, length = 1 << level;
+		assert(level <= MAX_M);
+		if (!(mask & (~uint64_t(0) >> (64 - PH::SIZE))))
+			return;
+		prepare(message, program++);
+		for (int i = 0; i < length; ++i)
+			soft[i+length] = codeword[i];
+		origin = 0;
+		program = decode(message, program, level, frozen);
+		assert(*program == 255);
+	}
+	// subtree() calls of a program with dynamic frozen bits need to know where its messages go
+	void prepare(const TYPE *message, const uint8_t *program)
+	{
+		start = program;
+		base = message;
+		known = used = 0;
+		mapped = false;
+		for (int i = 0; i < PERIOD; ++i)
+			parity[i] = PH::one();
+	}
+	const uint8_t *subtree(TYPE *&message, TYPE *result, const TYPE *input, const uint8_t *program, int level, int offset = 0)
+	{
+		int length = 1 << level;
+		assert(level <= MAX_M);
+		for (int i = 0; i < length; ++i)
+			soft[i+length] = input[i];
+		origin = offset;
+		program = decode(message, program, level, nullptr);
+		for (int i = 0; i < length; ++i)
+			result[i] = hard[i];
+		return program;
 	}
 };
 
+
+template <typename TYPE, int MAX_M, int MAX_L = 32, int PERIOD = 5>
+class PolarListDecoder
+{
+	static_assert(MAX_L >= 2 && MAX_L <= 64, "list size must fit into flip masks");
+	static_assert(PERIOD >= 1 && PERIOD <= 31, "parity register must fit into an int");
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::PATH PATH;
+	static const int MAX_N = 1 << MAX_M;
+	TYPE soft[MAX_L*MAX_N];
+	TYPE hard[2*MAX_L*MAX_N];
+	TYPE mess[MAX_L*MAX_N];
+	uint8_t prev[MAX_L*MAX_N];
+	TYPE temp[MAX_N];
+	int index[MAX_N];
+	int weak[MAX_L][MAX_L];
+	PATH metric[MAX_L];
+	PATH cmet[2*MAX_L];
+	uint64_t cflip[2*MAX_L];
+	int cpath[2*MAX_L];
+	int order[2*MAX_L];
+	int parent[MAX_L];
+	int parity[MAX_L];
+	int sidx[MAX_M][MAX_L], scnt[MAX_M][MAX_L], sfree[MAX_M][MAX_L], stop[MAX_M];
+	int hidx[MAX_M][MAX_L], hcnt[MAX_M][MAX_L], hfree[MAX_M][MAX_L], htop[MAX_M];
+	int side[MAX_M+1];
+	const TYPE *chan;
+	int level, paths, limit, count, offset;
+
+	const TYPE *soft_get(int lvl, int path)
+	{
+		if (lvl == level)
+			return chan;
+		return soft + MAX_L * ((1<<lvl)-1) + (sidx[lvl][path] << lvl);
+	}
+	TYPE *soft_put(int lvl, int path)
+	{
+		int &idx = sidx[lvl][path];
+		if (scnt[lvl][idx] > 1) {
+			--scnt[lvl][idx];
+			idx = sfree[lvl][--stop[lvl]];
+			scnt[lvl][idx] = 1;
+		}
+		return soft + MAX_L * ((1<<lvl)-1) + (idx << lvl);
+	}
+	const TYPE *hard_get(int lvl, int path)
+	{
+		return hard + MAX_L * ((2<<lvl)-2) + (hidx[lvl][path] << (lvl+1));
+	}
+	TYPE *hard_put(int lvl, int path, int keep)
+	{
+		int &idx = hidx[lvl][path];
+		TYPE *base = hard + MAX_L * ((2<<lvl)-2);
+		if (hcnt[lvl][idx] > 1) {
+			TYPE *old = base + (idx << (lvl+1));
+			--hcnt[lvl][idx];
+			idx = hfree[lvl][--htop[lvl]];
+			hcnt[lvl][idx] = 1;
+			for (int i = 0; i < keep; ++i)
+				base[(idx << (lvl+1))+i] = old[i];
+		}
+		return base + (idx << (lvl+1));
+	}
+	void fork(int num)
+	{
+		for (int l = 0; l < level; ++l) {
+			int sft[MAX_L], hrd[MAX_L];
+			for (int p = 0; p < num; ++p) {
+				++scnt[l][sft[p] = sidx[l][parent[p]]];
+				++hcnt[l][hrd[p] = hidx[l][parent[p]]];
+			}
+			for (int p = 0; p < paths; ++p) {
+				if (!--scnt[l][sidx[l][p]])
+					sfree[l][stop[l]++] = sidx[l][p];
+				if (!--hcnt[l][hidx[l][p]])
+					hfree[l][htop[l]++] = hidx[l][p];
+			}
+			for (int p = 0; p < num; ++p) {
+				sidx[l][p] = sft[p];
+				hidx[l][p] = hrd[p];
+			}
+		}
+		paths = num;
+	}
+	int prune(int num)
+	{
+		if (num <= limit)
+			return num;
+		for (int i = 0; i < num; ++i)
+			order[i] = i;
+		std::nth_element(order, order+limit, order+num, [this](int a, int b){ return cmet[a] < cmet[b]; });
+		PATH met[MAX_L];
+		uint64_t flp[MAX_L];
+		int pth[MAX_L];
+		for (int i = 0; i < limit; ++i) {
+			met[i] = cmet[order[i]];
+			flp[i] = cflip[order[i]];
+			pth[i] = cpath[order[i]];
+		}
+		for (int i = 0; i < limit; ++i) {
+			cmet[i] = met[i];
+			cflip[i] = flp[i];
+			cpath[i] = pth[i];
+		}
+		return limit;
+	}
+	void branch(int num)
+	{
+		int par[MAX_L];
+		for (int p = 0; p < num; ++p) {
+			parent[p] = cpath[p];
+			par[p] = parity[cpath[p]];
+		}
+		fork(num);
+		for (int p = 0; p < num; ++p) {
+			metric[p] = cmet[p];
+			parity[p] = par[p];
+		}
+	}
+	void weakest(int *wk, const TYPE *sft, int length, int depth)
+	{
+		for (int i = 0; i < length; ++i)
+			index[i] = i;
+		std::partial_sort(index, index+depth, index+length, [sft](int a, int b){ return PH::qabs(sft[a]) < PH::qabs(sft[b]); });
+		for (int i = 0; i < depth; ++i)
+			wk[i] = index[i];
+	}
+	void store(int lvl, int path)
+	{
+		if (lvl == level)
+			return;
+		int length = 1 << lvl;
+		TYPE *hrd = hard_put(lvl, path, side[lvl] * length) + side[lvl] * length;
+		for (int i = 0; i < length; ++i)
+			hrd[i] = temp[i];
+	}
+	void emit(int path, int first, int length)
+	{
+		for (int i = first; i < length; ++i) {
+			mess[MAX_L*(count+i-first)+path] = temp[i];
+			prev[MAX_L*(count+i-first)+path] = i == first ? parent[path] : path;
+			parity[path] ^= (temp[i] < 0) << (offset+i) % PERIOD;
+		}
+	}
+	void left(int lvl)
+	{
+		int length = 1 << lvl;
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = soft_get(lvl, p);
+			TYPE *out = soft_put(lvl-1, p);
+			for (int i = 0; i < length/2; ++i)
+				out[i] = PH::prod(inp[i], inp[i+length/2]);
+		}
+		side[lvl-1] = 0;
+	}
+	void right(int lvl)
+	{
+		int length = 1 << lvl;
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = soft_get(lvl, p);
+			const TYPE *hrd = hard_get(lvl-1, p);
+			TYPE *out = soft_put(lvl-1, p);
+			for (int i = 0; i < length/2; ++i)
+				out[i] = PH::madd(hrd[i], inp[i], inp[i+length/2]);
+		}
+		side[lvl-1] = 1;
+	}
+	void rate0_right(int lvl)
+	{
+		int length = 1 << lvl;
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = soft_get(lvl, p);
+			TYPE *out = soft_put(lvl-1, p);
+			PATH pen = 0;
+			for (int i = 0; i < length/2; ++i) {
+				TYPE sft = PH::prod(inp[i], inp[i+length/2]);
+				if (sft < 0)
+					pen -= sft;
+				out[i] = PH::qadd(inp[i], inp[i+length/2]);
+			}
+			metric[p] += pen;
+		}
+		side[lvl-1] = 1;
+		offset += length/2;
+	}
+	void comb(int lvl)
+	{
+		if (lvl == level)
+			return;
+		int length = 1 << lvl;
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = hard_get(lvl-1, p);
+			TYPE *out = hard_put(lvl, p, side[lvl] * length) + side[lvl] * length;
+			for (int i = 0; i < length/2; ++i) {
+				out[i] = PH::qmul(inp[i], inp[i+length/2]);
+				out[i+length/2] = inp[i+length/2];
+			}
+		}
+	}
+	void rate0_comb(int lvl)
+	{
+		if (lvl == level)
+			return;
+		int length = 1 << lvl;
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = hard_get(lvl-1, p);
+			TYPE *out = hard_put(lvl, p, side[lvl] * length) + side[lvl] * length;
+			for (int i = 0; i < length/2; ++i)
+				out[i] = out[i+length/2] = inp[i+length/2];
+		}
+	}
+	void rate0(int lvl)
+	{
+		int length = 1 << lvl;
+		for (int i = 0; i < length; ++i)
+			temp[i] = PH::one();
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *sft = soft_get(lvl, p);
+			PATH pen = 0;
+			for (int i = 0; i < length; ++i)
+				if (sft[i] < 0)
+					pen -= sft[i];
+			metric[p] += pen;
+			store(lvl, p);
+		}
+		offset += length;
+	}
+	void rate1(int lvl)
+	{
+		int length = 1 << lvl, num = 0;
+		int depth = std::min(limit-1, length);
+		for (int p = 0; p < paths; ++p) {
+			weakest(weak[p], soft_get(lvl, p), length, depth);
+			cpath[num] = p;
+			cflip[num] = 0;
+			cmet[num++] = metric[p];
+		}
+		for (int t = 0; t < depth; ++t) {
+			for (int c = 0, cnt = num; c < cnt; ++c) {
+				cpath[num] = cpath[c];
+				cflip[num] = cflip[c] | 1ULL << t;
+				cmet[num++] = cmet[c] + PATH(PH::qabs(soft_get(lvl, cpath[c])[weak[cpath[c]][t]]));
+			}
+			num = prune(num);
+		}
+		branch(num);
+		for (int p = 0; p < num; ++p) {
+			const TYPE *sft = soft_get(lvl, p);
+			for (int i = 0; i < length; ++i)
+				temp[i] = PH::decide(sft[i]);
+			for (int t = 0; t < depth; ++t)
+				if (cflip[p] >> t & 1)
+					temp[weak[parent[p]][t]] = -temp[weak[parent[p]][t]];
+			store(lvl, p);
+			polar_trans(temp, temp, length);
+			emit(p, 0, length);
+		}
+		count += length;
+		offset += length;
+	}
+	void rep(int lvl)
+	{
+		int length = 1 << lvl, num = 0;
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *sft = soft_get(lvl, p);
+			PATH pos = 0, neg = 0;
+			for (int i = 0; i < length; ++i) {
+				if (sft[i] < 0)
+					pos -= sft[i];
+				else
+					neg += sft[i];
+			}
+			cpath[num] = p;
+			cflip[num] = 0;
+			cmet[num++] = metric[p] + pos;
+			cpath[num] = p;
+			cflip[num] = 1;
+			cmet[num++] = metric[p] + neg;
+		}
+		num = prune(num);
+		branch(num);
+		for (int p = 0; p < num; ++p) {
+			TYPE bit = cflip[p] ? -PH::one() : PH::one();
+			for (int i = 0; i < length; ++i)
+				temp[i] = bit;
+			store(lvl, p);
+			emit(p, length-1, length);
+		}
+		count += 1;
+		offset += length;
+	}
+	void spc(int lvl)
+	{
+		int length = 1 << lvl, num = 0;
+		int depth = std::min(limit, length);
+		uint64_t odd[MAX_L];
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *sft = soft_get(lvl, p);
+			weakest(weak[p], sft, length, depth);
+			odd[p] = 0;
+			for (int i = 0; i < length; ++i)
+				odd[p] ^= sft[i] < 0;
+			cpath[num] = p;
+			cflip[num] = odd[p];
+			cmet[num++] = metric[p] + (odd[p] ? PATH(PH::qabs(sft[weak[p][0]])) : PATH(0));
+		}
+		for (int t = 1; t < depth; ++t) {
+			for (int c = 0, cnt = num; c < cnt; ++c) {
+				const TYPE *sft = soft_get(lvl, cpath[c]);
+				PATH least = PH::qabs(sft[weak[cpath[c]][0]]);
+				PATH pen = PH::qabs(sft[weak[cpath[c]][t]]);
+				cpath[num] = cpath[c];
+				cflip[num] = (cflip[c] ^ 1) | 1ULL << t;
+				cmet[num++] = cmet[c] + pen + (cflip[c] & 1 ? -least : least);
+			}
+			num = prune(num);
+		}
+		branch(num);
+		for (int p = 0; p < num; ++p) {
+			const TYPE *sft = soft_get(lvl, p);
+			for (int i = 0; i < length; ++i)
+				temp[i] = PH::decide(sft[i]);
+			for (int t = 0; t < depth; ++t)
+				if (cflip[p] >> t & 1)
+					temp[weak[parent[p]][t]] = -temp[weak[parent[p]][t]];
+			store(lvl, p);
+			polar_trans(temp, temp, length);
+			emit(p, 1, length);
+		}
+		count += length-1;
+		offset += length;
+	}
+	void decide(TYPE *bit, TYPE *other, const TYPE *sft, int type, int idx)
+	{
+		if (type) {
+			for (int p = 0; p < paths; ++p) {
+				bit[p] = type == 2 && parity[p] >> (offset+idx) % PERIOD & 1 ? -PH::one() : PH::one();
+				if ((sft[p] < 0) != (bit[p] < 0))
+					metric[p] += PATH(PH::qabs(sft[p]));
+			}
+			return;
+		}
+		int num = 0;
+		for (int p = 0; p < paths; ++p) {
+			cpath[num] = p;
+			cflip[num] = sft[p] < 0;
+			cmet[num++] = metric[p];
+			cpath[num] = p;
+			cflip[num] = sft[p] >= 0;
+			cmet[num++] = metric[p] + PATH(PH::qabs(sft[p]));
+		}
+		num = prune(num);
+		TYPE old[MAX_L];
+		for (int p = 0; p < paths; ++p)
+			old[p] = other[p];
+		branch(num);
+		for (int p = 0; p < num; ++p) {
+			other[p] = old[parent[p]];
+			bit[p] = temp[idx] = cflip[p] ? -PH::one() : PH::one();
+			emit(p, idx, idx+1);
+		}
+		count += 1;
+	}
+	void pair(int lvl, int pattern)
+	{
+		assert(lvl == 1);
+		TYPE sft[MAX_L], u0[MAX_L], u1[MAX_L];
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = soft_get(lvl, p);
+			sft[p] = PH::prod(inp[0], inp[1]);
+			u1[p] = PH::one();
+		}
+		decide(u0, u1, sft, pattern & 3, 0);
+		for (int p = 0; p < paths; ++p) {
+			const TYPE *inp = soft_get(lvl, p);
+			sft[p] = PH::madd(u0[p], inp[0], inp[1]);
+		}
+		decide(u1, u0, sft, pattern >> 2, 1);
+		for (int p = 0; p < paths; ++p) {
+			temp[0] = PH::qmul(u0[p], u1[p]);
+			temp[1] = u1[p];
+			store(lvl, p);
+		}
+		offset += 2;
+	}
+	void trace(TYPE *message, int path)
+	{
+		for (int t = count-1; t >= 0; --t) {
+			message[t] = mess[MAX_L*t+path];
+			path = prev[MAX_L*t+path];
+		}
+	}
+public:
+	// a program that is only a part of a longer code continues its parity register from position on
+	template <typename CHECK>
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, int list_size, CHECK check, int position = 0, int state = 0)
+	{
+		assert(list_size >= 1 && list_size <= MAX_L);
+		level = *program;
+		assert(level <= MAX_M);
+		chan = codeword;
+		limit = list_size;
+		paths = 1;
+		count = 0;
+		offset = position;
+		metric[0] = 0;
+		parity[0] = state;
+		for (int l = 0; l < level; ++l) {
+			sidx[l][0] = hidx[l][0] = 0;
+			scnt[l][0] = hcnt[l][0] = 1;
+			stop[l] = htop[l] = 0;
+			for (int i = MAX_L-1; i > 0; --i) {
+				sfree[l][stop[l]++] = i;
+				hfree[l][htop[l]++] = i;
+			}
+		}
+		side[level] = 0;
+		PolarCompiler::walk(program, [this](int op, int operand, int lvl, int) {
+			switch (op) {
+			case 0: left(lvl); break;
+			case 1: right(lvl); break;
+			case 2: comb(lvl); break;
+			case 3: rate0(lvl); break;
+			case 4: rate1(lvl); break;
+			case 5: rep(lvl); break;
+			case 6: spc(lvl); break;
+			case 7: rate0_right(lvl); break;
+			case 8: rate0_comb(lvl); break;
+			case 9: right(lvl); rate1(lvl-1); comb(lvl); break;
+			case 15: pair(lvl, operand); break;
+			default: assert(false);
+			}
+		});
+		for (int p = 0; p < paths; ++p)
+			order[p] = p;
+		std::sort(order, order+paths, [this](int a, int b){ return metric[a] < metric[b]; });
+		for (int r = 0; r < paths; ++r) {
+			trace(message, order[r]);
+			if (check(message))
+				return r;
+		}
+		trace(message, order[0]);
+		return -1;
+	}
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, int list_size)
+	{
+		return (*this)(message, codeword, program, list_size, [](const TYPE *){ return true; });
+	}
+};
@@ -6,7 +6,7 @@ Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
 
 #pragma once
 
-template <typename TYPE, int M>
+template <typename TYPE, int M, int PERIOD = 5>
 class PolarEncoder
 {
 	static const int N = 1 << M;
@@ -14,12 +14,17 @@ class PolarEncoder
 public:
 	void operator()(TYPE *codeword, const TYPE *message, const uint8_t *frozen)
 	{
-		for (int i = 0; i < N; i += 2) {
-			TYPE msg0 = frozen[i] ? PH::one() : *message++;
-			TYPE msg1 = frozen[i+1] ? PH::one() : *message++;
-			codeword[i] = PH::qmul(msg0, msg1);
-			codeword[i+1] = msg1;
+		TYPE parity[PERIOD];
+		for (int i = 0; i < PERIOD; ++i)
+			parity[i] = PH::one();
+		for (int i = 0; i < N; ++i) {
+			if (!frozen[i])
+				parity[i%PERIOD] = PH::qmul(parity[i%PERIOD], codeword[i] = *message++);
+			else
+				codeword[i] = frozen[i] == 2 ? parity[i%PERIOD] : PH::one();
 		}
+		for (int i = 0; i < N; i += 2)
+			codeword[i] = PH::qmul(codeword[i], codeword[i+1]);
 		for (int h = 2; h < N; h *= 2)
 			for (int i = 0; i < N; i += 2 * h)
 				for (int j = i; j < i + h; ++j)
@@ -36,6 +41,7 @@ public:
 	void operator()(TYPE *codeword, const TYPE *message, const uint8_t *frozen)
 	{
 		for (int i = 0; i < N; i += 2) {
+			assert(frozen[i] < 2 && frozen[i+1] < 2);
 			TYPE msg0 = frozen[i] ? PH::one() : *message++;
 			TYPE msg1 = frozen[i+1] ? PH::one() : *message++;
 			codeword[i] = PH::qmul(msg0, msg1);
@@ -58,3 +64,21 @@ public:
 	}
 };
 
+template <typename TYPE, int M, int POLY = 0155>
+class PolarPACEnc
+{
+	static_assert(POLY & 1, "convolutional precoder must be rate-1");
+	static const int N = 1 << M;
+	typedef PolarHelper<TYPE> PH;
+public:
+	void operator()(TYPE *codeword, const TYPE *message, const uint8_t *frozen)
+	{
+		for (int i = 0; i < N; ++i)
+			codeword[i] = frozen[i] ? PH::one() : *message++;
+		for (int i = N-1; i >= 0; --i)
+			for (int j = 1; (POLY >> j) && j <= i; ++j)
+				if (POLY >> j & 1)
+					codeword[i] = PH::qmul(codeword[i], codeword[i-j]);
+		polar_trans(codeword, codeword, N);
+	}
+};
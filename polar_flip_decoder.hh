@@ -0,0 +1,403 @@
+/*
+Successive cancellation flip decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int MAX_T = 32, int DEPTH = 4, int MAX_O = 3, int PERIOD = 5>
+class PolarFlipDecoder
+{
+	static_assert(PERIOD >= 1, "parity register needs at least one entry");
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::value_type VALUE;
+	static const int MAX_N = 1 << MAX_M;
+	static const int WIDTH = PH::SIZE;
+	static const int MAX_P = 3 << (DEPTH + 1);
+	struct Checkpoint
+	{
+		const uint8_t *program;
+		int lvl, off, msg, pos;
+	};
+	struct Flips
+	{
+		float metric;
+		int num, pos[MAX_O];
+	};
+	TYPE tsoft[DEPTH*MAX_N];
+	TYPE thard[(DEPTH+1)*MAX_N];
+	TYPE bsoft[MAX_N];
+	TYPE bhard[MAX_N];
+	TYPE temp[MAX_N];
+	TYPE mesg[MAX_N];
+	TYPE rel[MAX_N];
+	TYPE flip[MAX_N];
+	TYPE parity[PERIOD];
+	uint8_t cand[MAX_N];
+	uint8_t fixed[MAX_N];
+	Flips heap[WIDTH][MAX_T];
+	Flips flipped[WIDTH];
+	int heaps[WIDTH];
+	bool active[WIDTH];
+	Checkpoint point[MAX_P];
+	const uint8_t *start;
+	const TYPE *chan;
+	float alpha;
+	int level, top, points, tries, known, used;
+	bool mapped;
+
+	const TYPE *soft_get(int lvl, int off)
+	{
+		if (lvl == level)
+			return chan;
+		if (lvl < top)
+			return bsoft + (1 << lvl);
+		return tsoft + (lvl - top) * MAX_N + off;
+	}
+	TYPE *soft_put(int lvl, int off)
+	{
+		if (lvl < top)
+			return bsoft + (1 << lvl);
+		return tsoft + (lvl - top) * MAX_N + off;
+	}
+	TYPE *hard_at(int lvl, int off)
+	{
+		if (lvl < top)
+			return bhard + off;
+		return thard + (lvl - top) * MAX_N + off;
+	}
+	void left(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl, off);
+		TYPE *out = soft_put(lvl-1, off);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::prod(inp[i], inp[i+length/2]);
+	}
+	void right(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl, off);
+		const TYPE *hrd = hard_at(lvl-1, off);
+		TYPE *out = soft_put(lvl-1, off+length/2);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::madd(hrd[i], inp[i], inp[i+length/2]);
+	}
+	void rate0_right(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl, off);
+		TYPE *out = soft_put(lvl-1, off+length/2);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::qadd(inp[i], inp[i+length/2]);
+	}
+	void comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = hard_at(lvl-1, off);
+		TYPE *out = hard_at(lvl, off);
+		for (int i = 0; i < length/2; ++i) {
+			out[i] = PH::qmul(inp[i], inp[i+length/2]);
+			out[i+length/2] = inp[i+length/2];
+		}
+	}
+	void rate0_comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = hard_at(lvl-1, off);
+		TYPE *out = hard_at(lvl, off);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = out[i+length/2] = inp[i+length/2];
+	}
+	void rate0(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		TYPE *hrd = hard_at(lvl, off);
+		for (int i = 0; i < length; ++i)
+			hrd[i] = PH::one();
+	}
+	void rate1(int lvl, int off, int msg)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl, off);
+		TYPE *hrd = hard_at(lvl, off);
+		for (int i = 0; i < length; ++i) {
+			hrd[i] = PH::qmul(PH::decide(sft[i]), flip[off+i]);
+			rel[off+i] = PH::qabs(sft[i]);
+			cand[off+i] = 1;
+		}
+		polar_trans(mesg+msg, hrd, length);
+	}
+	void rep(int lvl, int off, int msg)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl, off);
+		for (int i = 0; i < length/2; ++i)
+			temp[i] = PH::qadd(sft[i], sft[i+length/2]);
+		for (int h = length/2; h > 1; h /= 2)
+			for (int i = 0; i < h/2; ++i)
+				temp[i] = PH::qadd(temp[i], temp[i+h/2]);
+		TYPE *hrd = hard_at(lvl, off);
+		TYPE hardi = PH::qmul(PH::decide(temp[0]), flip[off+length-1]);
+		rel[off+length-1] = PH::qabs(temp[0]);
+		cand[off+length-1] = 1;
+		mesg[msg] = hardi;
+		for (int i = 0; i < length; ++i)
+			hrd[i] = hardi;
+	}
+	void spc(int lvl, int off, int msg)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl, off);
+		TYPE *hrd = hard_at(lvl, off);
+		for (int i = 0; i < length; ++i)
+			hrd[i] = PH::qmul(PH::decide(sft[i]), flip[off+i]);
+		TYPE parity = hrd[0];
+		for (int i = 1; i < length; ++i)
+			parity = PH::qmul(parity, hrd[i]);
+		for (int i = 0; i < length; ++i)
+			temp[i] = PH::qabs(sft[i]);
+		TYPE weak = temp[0];
+		for (int i = 1; i < length; ++i)
+			weak = PH::qmin(weak, temp[i]);
+		for (int i = 0; i < length; ++i) {
+			hrd[i] = PH::flip(hrd[i], parity, weak, temp[i]);
+			rel[off+i] = PH::flip(temp[i], PH::zero(), weak, temp[i]);
+			cand[off+i] = 2;
+		}
+		polar_trans(temp, hrd, length);
+		for (int i = 0; i < length-1; ++i)
+			mesg[msg+i] = temp[i+1];
+	}
+	int pair(int off, int msg, int pattern)
+	{
+		if (!mapped) {
+			PolarCompiler::freeze(fixed, start);
+			mapped = true;
+		}
+		for (; known < off; ++known)
+			if (!fixed[known])
+				parity[known%PERIOD] = PH::qmul(parity[known%PERIOD], mesg[used++]);
+		const TYPE *sft = soft_get(1, off);
+		TYPE *hrd = hard_at(1, off);
+		TYPE u[2];
+		int count = 0;
+		for (int i = 0; i < 2; ++i) {
+			TYPE *reg = parity + (off + i) % PERIOD;
+			switch (pattern >> 2*i & 3) {
+			case 0: {
+				TYPE sum = i ? PH::madd(u[0], sft[0], sft[1]) : PH::prod(sft[0], sft[1]);
+				u[i] = mesg[msg+count++] = PH::qmul(PH::decide(sum), flip[off+i]);
+				rel[off+i] = PH::qabs(sum);
+				cand[off+i] = 1;
+				*reg = PH::qmul(*reg, u[i]);
+				++used;
+				break;
+			}
+			case 1: u[i] = PH::one(); break;
+			default: u[i] = *reg;
+			}
+		}
+		known = off + 2;
+		hrd[0] = PH::qmul(u[0], u[1]);
+		hrd[1] = u[1];
+		return count;
+	}
+	int decode(const uint8_t *program, int lvl, int off, int msg, bool record)
+	{
+		known = used = 0;
+		for (int i = 0; i < PERIOD; ++i)
+			parity[i] = PH::one();
+		while (*program != 255) {
+			if (record && lvl >= top) {
+				assert(points < MAX_P);
+				Checkpoint &cp = point[points++];
+				cp.program = program;
+				cp.lvl = lvl;
+				cp.off = off;
+				cp.msg = msg;
+				switch (*program) {
+				case 1:
+				case 2:
+				case 8:
+				case 9: cp.pos = off + (1 << lvl); break;
+				default: cp.pos = off;
+				}
+			}
+			program = PolarCompiler::step(program, lvl, off, [this, &msg](int op, int operand, int lvl, int off) {
+				switch (op) {
+				case 0: left(lvl, off); break;
+				case 1: right(lvl, off); break;
+				case 2: comb(lvl, off); break;
+				case 3: rate0(lvl, off); break;
+				case 4: rate1(lvl, off, msg); msg += 1 << lvl; break;
+				case 5: rep(lvl, off, msg); ++msg; break;
+				case 6: spc(lvl, off, msg); msg += (1 << lvl) - 1; break;
+				case 7: rate0_right(lvl, off); break;
+				case 8: rate0_comb(lvl, off); break;
+				case 9: right(lvl, off); rate1(lvl-1, off+(1<<(lvl-1)), msg); msg += 1 << (lvl-1); comb(lvl, off); break;
+				case 15: assert(lvl == 1); msg += pair(off, msg, operand); break;
+				default: assert(false);
+				}
+			});
+		}
+		assert(lvl == level);
+		return msg;
+	}
+	static bool worse(const Flips &a, const Flips &b)
+	{
+		return a.metric < b.metric;
+	}
+	bool eligible(int i, int lane)
+	{
+		return cand[i] == 1 || (cand[i] == 2 && PH::get(rel[i], lane) > 0);
+	}
+	void insert(int lane, const Flips &parent, int pos, float metric)
+	{
+		Flips *list = heap[lane];
+		int &num = heaps[lane];
+		if (num == tries) {
+			if (!num || metric >= list[0].metric)
+				return;
+			std::pop_heap(list, list+num--, worse);
+		}
+		Flips &flips = list[num++];
+		flips.metric = metric;
+		flips.num = parent.num + 1;
+		for (int i = 0; i < parent.num; ++i)
+			flips.pos[i] = parent.pos[i];
+		flips.pos[parent.num] = pos;
+		std::push_heap(list, list+num, worse);
+	}
+	void expand(int lane, const Flips &parent)
+	{
+		int length = 1 << level;
+		int first = 0;
+		for (int i = 0; i < parent.num; ++i)
+			first = std::max(first, parent.pos[i] + 1);
+		float sum = parent.metric;
+		for (int i = first; i < length; ++i) {
+			if (eligible(i, lane)) {
+				float value = PH::get(rel[i], lane);
+				if (alpha > 0)
+					sum += std::log1p(std::exp(-alpha * value)) / alpha;
+				insert(lane, parent, i, sum + value);
+			}
+		}
+	}
+	void best(int lane, Flips &flips)
+	{
+		Flips *list = heap[lane];
+		int &num = heaps[lane], pick = 0;
+		for (int i = 1; i < num; ++i)
+			if (list[i].metric < list[pick].metric)
+				pick = i;
+		flips = list[pick];
+		list[pick] = list[--num];
+		std::make_heap(list, list+num, worse);
+	}
+	int change(int lane, const Flips &next)
+	{
+		Flips &prev = flipped[lane];
+		int pos = 1 << level;
+		for (int i = 0, j = 0; i < prev.num || j < next.num;) {
+			if (j == next.num || (i < prev.num && prev.pos[i] < next.pos[j])) {
+				PH::set(flip+prev.pos[i], lane, 1);
+				pos = std::min(pos, prev.pos[i++]);
+			} else if (i == prev.num || next.pos[j] < prev.pos[i]) {
+				PH::set(flip+next.pos[j], lane, -1);
+				pos = std::min(pos, next.pos[j++]);
+			} else {
+				++i;
+				++j;
+			}
+		}
+		prev = next;
+		return pos;
+	}
+	int resume(int pos)
+	{
+		int first = 0, last = points;
+		while (last - first > 1) {
+			int mid = (first + last) / 2;
+			if (point[mid].pos <= pos)
+				first = mid;
+			else
+				last = mid;
+		}
+		return first;
+	}
+public:
+	template <typename CHECK>
+	int operator()(int *result, TYPE *message, const TYPE *codeword, const uint8_t *program, int attempts, CHECK check, int order = 1, float alpha = 0, uint64_t mask = ~uint64_t(0))
+	{
+		static_assert(WIDTH <= 64, "lanes must fit into mask");
+		assert(attempts >= 0 && attempts <= MAX_T);
+		assert(order >= 1 && order <= MAX_O);
+		start = program;
+		mapped = false;
+		level = *program++;
+		assert(level <= MAX_M);
+		top = std::max(level - DEPTH, 0);
+		chan = codeword;
+		tries = attempts;
+		this->alpha = alpha;
+		int length = 1 << level;
+		for (int i = 0; i < length; ++i) {
+			flip[i] = PH::one();
+			cand[i] = 0;
+		}
+		for (int k = 0; k < WIDTH; ++k)
+			result[k] = 0;
+		if (!(mask & (~uint64_t(0) >> (64 - WIDTH))))
+			return 0;
+		points = 0;
+		int count = decode(program, level, 0, 0, true);
+		int failed = 0;
+		for (int k = 0; k < WIDTH; ++k) {
+			flipped[k].num = 0;
+			flipped[k].metric = 0;
+			heaps[k] = 0;
+			if (!(mask >> k & 1))
+				continue;
+			result[k] = check(mesg, k) ? 0 : -1;
+			if (result[k] < 0) {
+				expand(k, flipped[k]);
+				++failed;
+			}
+		}
+		int total = 0;
+		for (int i = 0; i < count; ++i)
+			message[i] = mesg[i];
+		for (int t = 0; failed && t < attempts; ++t) {
+			int pos = length;
+			for (int k = 0; k < WIDTH; ++k) {
+				active[k] = result[k] < 0 && heaps[k];
+				if (active[k]) {
+					Flips next;
+					best(k, next);
+					pos = std::min(pos, change(k, next));
+				}
+			}
+			if (pos == length)
+				break;
+			Checkpoint &cp = point[resume(pos)];
+			decode(cp.program, cp.lvl, cp.off, cp.msg, false);
+			++total;
+			for (int k = 0; k < WIDTH; ++k) {
+				if (!active[k])
+					continue;
+				if (check(mesg, k)) {
+					result[k] = t + 1;
+					for (int i = 0; i < count; ++i)
+						PH::set(message+i, k, PH::get(mesg[i], k));
+					--failed;
+				} else if (flipped[k].num < order) {
+					expand(k, flipped[k]);
+				}
+			}
+		}
+		return total;
+	}
+};
@@ -34,15 +34,27 @@ public:
 template <int MAX_M>
 class PolarCodeConst0
 {
-	void compute(long double pe, int i, int h)
+	long double prob[1<<MAX_M];
+	int index[1<<MAX_M];
+public:
+	void operator()(uint8_t *frozen_bits, int level, int K, long double erasure_probability = std::exp(-1.L))
 	{
-		if (h) {
-			compute(pe * (2-pe), i, h/2);
-			compute(pe * pe, i+h, h/2);
-		} else {
-			prob[i] = pe;
-		}
+		assert(level <= MAX_M);
+		int length = 1 << level;
+		polar_erasure(prob, erasure_probability, length);
+		for (int i = 0; i < length; ++i)
+			index[i] = i;
+		std::nth_element(index, index+K, index+length, [this](int a, int b){ return prob[a] < prob[b]; });
+		for (int i = 0; i < K; ++i)
+			frozen_bits[index[i]] = 0;
+		for (int i = K; i < length; ++i)
+			frozen_bits[index[i]] = 1;
 	}
+};
+
+template <int MAX_M>
+class PolarRMProfile
+{
 	long double prob[1<<MAX_M];
 	int index[1<<MAX_M];
 public:
@@ -50,10 +62,12 @@ public:
 	{
 		assert(level <= MAX_M);
 		int length = 1 << level;
-		compute(erasure_probability, 0, length / 2);
+		polar_erasure(prob, erasure_probability, length);
 		for (int i = 0; i < length; ++i)
 			index[i] = i;
-		std::nth_element(index, index+K, index+length, [this](int a, int b){ return prob[a] < prob[b]; });
+		std::nth_element(index, index+K, index+length, [this](int a, int b){
+			int wa = __builtin_popcount(a), wb = __builtin_popcount(b);
+			return wa != wb ? wa > wb : prob[a] < prob[b]; });
 		for (int i = 0; i < K; ++i)
 			frozen_bits[index[i]] = 0;
 		for (int i = K; i < length; ++i)
@@ -61,3 +75,26 @@ public:
 	}
 };
 
+template <int MAX_M>
+class PolarPCConst
+{
+	long double prob[1<<MAX_M];
+	int index[1<<MAX_M];
+public:
+	void operator()(uint8_t *frozen_bits, int level, int K, int P, long double erasure_probability = std::exp(-1.L))
+	{
+		assert(level <= MAX_M);
+		int length = 1 << level;
+		assert(K + P <= length);
+		polar_erasure(prob, erasure_probability, length);
+		for (int i = 0; i < length; ++i)
+			index[i] = i;
+		std::sort(index, index+length, [this](int a, int b){ return prob[a] < prob[b]; });
+		for (int i = 0; i < K; ++i)
+			frozen_bits[index[i]] = 0;
+		for (int i = K; i < K+P; ++i)
+			frozen_bits[index[i]] = 2;
+		for (int i = K+P; i < length; ++i)
+			frozen_bits[index[i]] = 1;
+	}
+};
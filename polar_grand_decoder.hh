@@ -0,0 +1,96 @@
+/*
+Ordered reliability bits guessing random additive noise decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+#include <algorithm>
+
+template <typename TYPE, int MAX_M>
+class PolarGRANDDecoder
+{
+	static_assert(MAX_M <= 8, "frozen bits must fit into one row vector");
+	typedef PolarHelper<TYPE> PH;
+	typedef SIMD<uint64_t, 4> ROW;
+	static const int MAX_N = 1 << MAX_M;
+	ROW col[MAX_N+1];
+	ROW syn;
+	int perm[MAX_N];
+	int part[MAX_N];
+	TYPE temp[MAX_N];
+	int64_t queries, limit;
+	int length, parts;
+
+	static int get(const ROW &row, int j)
+	{
+		return row.v[j>>6] >> (j&63) & 1;
+	}
+	static void set(ROW &row, int j)
+	{
+		row.v[j>>6] ^= uint64_t(1) << (j&63);
+	}
+	static bool equal(ROW a, ROW b)
+	{
+		ROW diff = veor(a, b);
+		return !(diff.v[0] | diff.v[1] | diff.v[2] | diff.v[3]);
+	}
+	bool search(ROW acc, int weight, int most)
+	{
+		if (!weight) {
+			++queries;
+			return equal(acc, syn);
+		}
+		for (int p = std::min(weight, most); p > 0 && p * (p + 1) / 2 >= weight; --p) {
+			if (queries >= limit)
+				return false;
+			part[parts++] = p;
+			if (search(veor(acc, col[p]), weight - p, p - 1))
+				return true;
+			--parts;
+		}
+		return false;
+	}
+public:
+	int64_t operator()(TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, int64_t max_queries)
+	{
+		assert(level <= MAX_M);
+		length = 1 << level;
+		for (int j = 0; j < length; ++j)
+			perm[j] = j;
+		std::sort(perm, perm+length, [codeword](int a, int b){ return PH::qabs(codeword[a]) < PH::qabs(codeword[b]); });
+		for (int i = 0; i < length; ++i)
+			temp[i] = PH::decide(codeword[i]);
+		polar_trans(temp, temp, length);
+		syn = vzero<ROW>();
+		for (int r = 1; r <= length; ++r)
+			col[r] = vzero<ROW>();
+		for (int i = 0, f = 0; i < length; ++i) {
+			assert(frozen[i] < 2);
+			if (!frozen[i])
+				continue;
+			if (temp[i] < 0)
+				set(syn, f);
+			for (int r = 1; r <= length; ++r)
+				if ((i & perm[r-1]) == i)
+					set(col[r], f);
+			++f;
+		}
+		queries = 0;
+		limit = max_queries;
+		parts = 0;
+		bool found = false;
+		for (int weight = 0; !found && weight <= length * (length + 1) / 2 && queries < limit; ++weight)
+			found = search(vzero<ROW>(), weight, length);
+		for (int i = 0; i < length; ++i)
+			temp[i] = PH::decide(codeword[i]);
+		for (int k = 0; found && k < parts; ++k)
+			temp[perm[part[k]-1]] = -temp[perm[part[k]-1]];
+		polar_trans(temp, temp, length);
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i])
+				*message++ = temp[i];
+		return found ? queries : -1;
+	}
+};
@@ -0,0 +1,116 @@
+/*
+Successive cancellation decoding of polar codes with half precision storage
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <int MAX_M, int WIDTH>
+class PolarHalfDecoder
+{
+	typedef SIMD<float, WIDTH> FLOAT;
+	typedef SIMD<half_t, WIDTH> HALF;
+	typedef PolarHelper<FLOAT> PH;
+	static const int MAX_N = 1 << MAX_M;
+	PolarDecoder<FLOAT, MAX_M> lower;
+	HALF soft[2*MAX_N];
+	HALF hard[MAX_N];
+	FLOAT input[MAX_N];
+	FLOAT result[MAX_N];
+
+	static FLOAT load(HALF a)
+	{
+		return vcvt_float(a.m);
+	}
+	static HALF store(FLOAT a)
+	{
+		HALF tmp;
+		tmp.m = vcvt_half(a);
+		return tmp;
+	}
+	// sums are clamped to the largest finite half, so infinities never meet and turn into NaN
+	static HALF clamp(FLOAT a)
+	{
+		return store(vclamp(a, -65504.f, 65504.f));
+	}
+	void left(int level)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length/2; ++i)
+			soft[i+length/2] = store(PH::prod(load(soft[i+length]), load(soft[i+length/2+length])));
+	}
+	void right(int level, int pos)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length/2; ++i)
+			soft[i+length/2] = clamp(PH::madd(load(hard[pos+i]), load(soft[i+length]), load(soft[i+length/2+length])));
+	}
+	void rate0_right(int level)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length/2; ++i)
+			soft[i+length/2] = clamp(PH::qadd(load(soft[i+length]), load(soft[i+length/2+length])));
+	}
+	void comb(int level, int pos)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length/2; ++i)
+			hard[pos+i] = store(PH::qmul(load(hard[pos+i]), load(hard[pos+i+length/2])));
+	}
+	void rate0_comb(int level, int pos)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length/2; ++i)
+			hard[pos+i] = hard[pos+i+length/2];
+	}
+	const uint8_t *subtree(FLOAT *&msg, int pos, const uint8_t *program, int level)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length; ++i)
+			input[i] = load(soft[i+length]);
+		program = lower.subtree(msg, result, input, program, level, pos);
+		for (int i = 0; i < length; ++i)
+			hard[pos+i] = store(result[i]);
+		return program;
+	}
+public:
+	// the levels above boundary keep their soft and hard values as half, leaf nodes and the levels below run in float
+	void operator()(FLOAT *message, const HALF *codeword, const uint8_t *program, int boundary = 10)
+	{
+		static const uint8_t rate1[1] = { 4 };
+		FLOAT *msg = message;
+		int level = *program, lvl = level, length = 1 << level, pos = 0;
+		assert(level <= MAX_M);
+		lower.prepare(message, program++);
+		if (level <= boundary) {
+			for (int i = 0; i < length; ++i)
+				input[i] = load(codeword[i]);
+			program = lower.subtree(msg, result, input, program, level);
+			assert(*program == 255);
+			return;
+		}
+		for (int i = 0; i < length; ++i)
+			soft[i+length] = codeword[i];
+		do {
+			switch (*program) {
+			case 0: case 1: case 2: case 7: case 8: case 9:
+				program = PolarCompiler::step(program, lvl, pos, [this, &msg](int op, int, int lvl, int pos) {
+					switch (op) {
+					case 0: left(lvl); break;
+					case 1: right(lvl, pos); break;
+					case 2: comb(lvl, pos); break;
+					case 7: rate0_right(lvl); break;
+					case 8: rate0_comb(lvl, pos); break;
+					case 9: right(lvl, pos); subtree(msg, pos + (1<<(lvl-1)), rate1, lvl-1); comb(lvl, pos); break;
+					}
+				});
+				break;
+			default: program = subtree(msg, pos, program, lvl); continue;
+			}
+			if (lvl <= boundary)
+				program = subtree(msg, pos, program, lvl);
+		} while (lvl != level);
+		assert(*program == 255);
+	}
+};
@@ -0,0 +1,283 @@
+/*
+Hard decision and erasure successive cancellation decoding of polar codes on bit-sliced frames
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <int MAX_M, int WIDTH = 1>
+class PolarHardDecoder
+{
+	typedef SIMD<uint64_t, WIDTH> TYPE;
+	static const int MAX_N = 1 << MAX_M;
+	// soft values saturate at a magnitude of three, sign and both magnitude bits each live in their own plane
+	struct Soft
+	{
+		TYPE sgn, lo, hi;
+	};
+	Soft val[MAX_N];
+	TYPE hard[MAX_N];
+	TYPE input[MAX_N], known[MAX_N];
+	const TYPE *chan, *cert;
+	TYPE *mesg, guess, full, none;
+	int level;
+	bool ahead;
+
+	// the channel level is read in place, every bit that was not erased has a magnitude of one
+	template <typename FUNC>
+	void fetch(int lvl, FUNC func)
+	{
+		if (lvl != level) {
+			const Soft *v = val + (1 << lvl);
+			func([v](int i) { return v[i]; });
+		} else if (cert) {
+			func([this](int i) { return Soft { chan[i], cert[i], none }; });
+		} else {
+			func([this](int i) { return Soft { chan[i], full, none }; });
+		}
+	}
+	static TYPE less(TYPE alo, TYPE ahi, TYPE blo, TYPE bhi)
+	{
+		return vorr(vbic(bhi, ahi), vbic(vbic(blo, alo), veor(ahi, bhi)));
+	}
+	static Soft minimum(Soft a, Soft b)
+	{
+		TYPE lt = less(a.lo, a.hi, b.lo, b.hi);
+		return Soft { veor(a.sgn, b.sgn), vbsl(lt, a.lo, b.lo), vbsl(lt, a.hi, b.hi) };
+	}
+	// equal signs add up the magnitudes, else the smaller one is taken off the larger one
+	static Soft add(Soft a, Soft b)
+	{
+		TYPE same = vbic(vdup<TYPE>(~uint64_t(0)), veor(a.sgn, b.sgn));
+		TYPE gt = less(b.lo, b.hi, a.lo, a.hi);
+		TYPE xlo = veor(a.lo, b.lo), xhi = veor(a.hi, b.hi), carry = vand(a.lo, b.lo);
+		TYPE over = vorr(vand(a.hi, b.hi), vand(carry, xhi));
+		TYPE borrow = vand(xlo, vbsl(gt, b.lo, a.lo));
+		TYPE hi = vbsl(same, vorr(veor(xhi, carry), over), veor(xhi, borrow));
+		return Soft { vbsl(vorr(same, gt), a.sgn, b.sgn), vorr(xlo, vand(same, over)), hi };
+	}
+	static TYPE decide(Soft a)
+	{
+		return vand(a.sgn, vorr(a.lo, a.hi));
+	}
+	// when a left step follows, its half is computed in the same pass while the inputs are still in registers
+	template <typename FUNC>
+	void produce(int lvl, bool fuse, FUNC func)
+	{
+		int half = 1 << (lvl-1);
+		Soft *out = val + half;
+		if (!fuse) {
+			for (int i = 0; i < half; ++i)
+				out[i] = func(i);
+			return;
+		}
+		int quarter = half / 2;
+		for (int i = 0; i < quarter; ++i) {
+			Soft a = func(i), b = func(quarter+i);
+			out[i] = a;
+			out[quarter+i] = b;
+			val[quarter+i] = minimum(a, b);
+		}
+		ahead = true;
+	}
+	void left(int lvl, bool fuse)
+	{
+		if (ahead) {
+			ahead = false;
+			return;
+		}
+		int half = 1 << (lvl-1);
+		fetch(lvl, [this, lvl, fuse, half](auto in) {
+			produce(lvl, fuse, [in, half](int i) { return minimum(in(i), in(half+i)); });
+		});
+	}
+	void right(int lvl, int pos, bool fuse)
+	{
+		int half = 1 << (lvl-1);
+		const TYPE *h = hard + pos;
+		fetch(lvl, [this, lvl, fuse, half, h](auto in) {
+			produce(lvl, fuse, [in, half, h](int i) {
+				Soft a = in(i);
+				a.sgn = veor(a.sgn, h[i]);
+				return add(a, in(half+i));
+			});
+		});
+	}
+	void rate0_right(int lvl, bool fuse)
+	{
+		int half = 1 << (lvl-1);
+		fetch(lvl, [this, lvl, fuse, half](auto in) {
+			produce(lvl, fuse, [in, half](int i) { return add(in(i), in(half+i)); });
+		});
+	}
+	void comb(int lvl, int pos)
+	{
+		int length = 1 << lvl, half = length / 2;
+		for (int i = 0; i < half; ++i)
+			hard[pos+i] = veor(hard[pos+i], hard[pos+half+i]);
+	}
+	void rate0_comb(int lvl, int pos)
+	{
+		int length = 1 << lvl, half = length / 2;
+		for (int i = 0; i < half; ++i)
+			hard[pos+i] = hard[pos+half+i];
+	}
+	void rate0(int lvl, int pos)
+	{
+		int length = 1 << lvl;
+		for (int i = 0; i < length; ++i)
+			hard[pos+i] = none;
+	}
+	void emit(int pos, int first, int length)
+	{
+		TYPE *out = mesg - first;
+		for (int i = first; i < length; ++i)
+			out[i] = hard[pos+i];
+		for (int h = 1; h < length; h *= 2)
+			for (int i = 0; i < length; i += 2 * h)
+				for (int j = i > first ? i : first; j < i + h; ++j)
+					out[j] = veor(out[j], out[j+h]);
+		mesg += length - first;
+	}
+	void rate1(int lvl, int pos)
+	{
+		int length = 1 << lvl;
+		fetch(lvl, [this, length, pos](auto in) {
+			for (int i = 0; i < length; ++i) {
+				Soft a = in(i);
+				hard[pos+i] = decide(a);
+				guess = vorr(guess, vbic(full, vorr(a.lo, a.hi)));
+			}
+		});
+		emit(pos, 0, length);
+	}
+	// carry-save adds two planes of the same weight, the carry only ripples as far as the count can reach
+	static void tally(TYPE *count, int digit, int top, TYPE a, TYPE b)
+	{
+		TYPE sum = veor(count[digit], a);
+		TYPE carry = vorr(vand(count[digit], a), vand(sum, b));
+		count[digit] = veor(sum, b);
+		for (int d = digit + 1; d < top; ++d) {
+			TYPE c = vand(count[d], carry);
+			count[d] = veor(count[d], carry);
+			carry = c;
+		}
+	}
+	// the magnitudes of both signs are counted up separately and the larger count wins, a tie is a guess
+	void rep(int lvl, int pos)
+	{
+		int length = 1 << lvl, top = 0, most = 0;
+		TYPE pos_count[MAX_M+2], neg_count[MAX_M+2];
+		for (int d = 0; d < lvl + 2; ++d)
+			pos_count[d] = neg_count[d] = none;
+		fetch(lvl, [&](auto in) {
+			for (int i = 0; i < length; i += 2) {
+				Soft a = in(i), b = length > 1 ? in(i+1) : Soft { none, none, none };
+				for (int w = 0; w < 2; ++w) {
+					most += 2 << w;
+					while (1 << top <= most)
+						++top;
+					TYPE am = w ? a.hi : a.lo, bm = w ? b.hi : b.lo;
+					tally(pos_count, w, top, vbic(am, a.sgn), vbic(bm, b.sgn));
+					tally(neg_count, w, top, vand(am, a.sgn), vand(bm, b.sgn));
+				}
+			}
+		});
+		TYPE bit = none, tie = full;
+		for (int d = top - 1; d >= 0; --d) {
+			bit = vorr(bit, vbic(vand(tie, neg_count[d]), pos_count[d]));
+			tie = vbic(tie, veor(neg_count[d], pos_count[d]));
+		}
+		guess = vorr(guess, tie);
+		for (int i = 0; i < length; ++i)
+			hard[pos+i] = bit;
+		*mesg++ = bit;
+	}
+	// a parity violation is blamed on the first bit with the smallest magnitude, more than one erasure is a guess
+	void spc(int lvl, int pos)
+	{
+		int length = 1 << lvl;
+		fetch(lvl, [this, length, pos](auto in) {
+			TYPE parity = none, lo = full, hi = full, seen = none, twice = none;
+			for (int i = 0; i < length; ++i) {
+				Soft a = in(i);
+				TYPE bit = decide(a), weak = vbic(full, vorr(a.lo, a.hi));
+				TYPE lt = less(a.lo, a.hi, lo, hi);
+				hard[pos+i] = bit;
+				parity = veor(parity, bit);
+				lo = vbsl(lt, a.lo, lo);
+				hi = vbsl(lt, a.hi, hi);
+				twice = vorr(twice, vand(seen, weak));
+				seen = vorr(seen, weak);
+			}
+			for (int i = 0; i < length; ++i) {
+				Soft a = in(i);
+				TYPE least = vbic(full, vorr(veor(a.lo, lo), veor(a.hi, hi)));
+				hard[pos+i] = veor(hard[pos+i], vand(parity, least));
+				parity = vbic(parity, least);
+			}
+			guess = vorr(guess, twice);
+		});
+		emit(pos, 1, length);
+	}
+	void decode(TYPE *message, const uint8_t *program)
+	{
+		level = *program++;
+		assert(level <= MAX_M);
+		mesg = message;
+		guess = none;
+		ahead = false;
+		// the partial sums of the combinations after the last leaf are never read
+		const uint8_t *end = program;
+		while (*end != 255)
+			++end;
+		while (end[-1] == 2 || end[-1] == 8)
+			--end;
+		int lvl = level, pos = 0;
+		while (program != end) {
+			bool fuse = program[1] == 0;
+			program = PolarCompiler::step(program, lvl, pos, [this, fuse](int op, int, int lvl, int pos) {
+				switch (op) {
+				case 0: left(lvl, fuse); break;
+				case 1: right(lvl, pos, fuse); break;
+				case 2: comb(lvl, pos); break;
+				case 3: rate0(lvl, pos); break;
+				case 4: rate1(lvl, pos); break;
+				case 5: rep(lvl, pos); break;
+				case 6: spc(lvl, pos); break;
+				case 7: rate0_right(lvl, fuse); break;
+				case 8: rate0_comb(lvl, pos); break;
+				case 9: right(lvl, pos, false); rate1(lvl-1, pos + (1<<(lvl-1))); comb(lvl, pos); break;
+				default: assert(false);
+				}
+			});
+		}
+	}
+public:
+	PolarHardDecoder() : full(vdup<TYPE>(~uint64_t(0))), none(vdup<TYPE>(0))
+	{
+	}
+	// lane k of codeword[i] holds bit i of frame k, set bits are ones (negative soft values)
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *program)
+	{
+		chan = codeword;
+		cert = nullptr;
+		decode(message, program);
+		return mesg - message;
+	}
+	// the lanes of the returned plane are set for frames where an erased information bit had to be guessed
+	TYPE operator()(TYPE *message, const TYPE *codeword, const TYPE *erasures, const uint8_t *program)
+	{
+		int length = 1 << *program;
+		assert(*program <= MAX_M);
+		for (int i = 0; i < length; ++i) {
+			input[i] = vbic(codeword[i], erasures[i]);
+			known[i] = vbic(full, erasures[i]);
+		}
+		chan = input;
+		cert = known;
+		decode(message, program);
+		return guess;
+	}
+};
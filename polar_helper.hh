@@ -9,6 +9,17 @@ Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
 template <typename TYPE>
 struct PolarHelper
 {
+	typedef TYPE PATH;
+	typedef TYPE value_type;
+	static const int SIZE = 1;
+	static value_type get(TYPE a, int)
+	{
+		return a;
+	}
+	static void set(TYPE *a, int, value_type v)
+	{
+		*a = v;
+	}
 	static TYPE one()
 	{
 		return 1;
@@ -17,6 +28,10 @@ struct PolarHelper
 	{
 		return 0;
 	}
+	static TYPE minus()
+	{
+		return -1;
+	}
 	static TYPE signum(TYPE v)
 	{
 		return (v > 0) - (v < 0);
@@ -58,12 +73,27 @@ struct PolarHelper
 	{
 		return c == d ? qmul(a, b) : a;
 	}
+	static TYPE freeze(TYPE a, TYPE f)
+	{
+		return f > 0 ? one() : a;
+	}
 };
 
 template <typename VALUE, int WIDTH>
 struct PolarHelper<SIMD<VALUE, WIDTH>>
 {
 	typedef SIMD<VALUE, WIDTH> TYPE;
+	typedef VALUE PATH;
+	typedef VALUE value_type;
+	static const int SIZE = WIDTH;
+	static value_type get(TYPE a, int i)
+	{
+		return a.v[i];
+	}
+	static void set(TYPE *a, int i, value_type v)
+	{
+		a->v[i] = v;
+	}
 	static TYPE one()
 	{
 		return vdup<TYPE>(1);
@@ -72,6 +102,10 @@ struct PolarHelper<SIMD<VALUE, WIDTH>>
 	{
 		return vzero<TYPE>();
 	}
+	static TYPE minus()
+	{
+		return vdup<TYPE>(-1);
+	}
 	static TYPE signum(TYPE a)
 	{
 		return vsignum(a);
@@ -108,12 +142,27 @@ struct PolarHelper<SIMD<VALUE, WIDTH>>
 	{
 		return vreinterpret<TYPE>(vbsl(vceq(c, d), vmask(qmul(a, b)), vmask(a)));
 	}
+	static TYPE freeze(TYPE a, TYPE f)
+	{
+		return vreinterpret<TYPE>(vbsl(vcgtz(f), vmask(one()), vmask(a)));
+	}
 };
 
 template <int WIDTH>
 struct PolarHelper<SIMD<int8_t, WIDTH>>
 {
 	typedef SIMD<int8_t, WIDTH> TYPE;
+	typedef int PATH;
+	typedef int8_t value_type;
+	static const int SIZE = WIDTH;
+	static value_type get(TYPE a, int i)
+	{
+		return a.v[i];
+	}
+	static void set(TYPE *a, int i, value_type v)
+	{
+		a->v[i] = v;
+	}
 	static TYPE one()
 	{
 		return vdup<TYPE>(1);
@@ -122,6 +171,10 @@ struct PolarHelper<SIMD<int8_t, WIDTH>>
 	{
 		return vzero<TYPE>();
 	}
+	static TYPE minus()
+	{
+		return vdup<TYPE>(-1);
+	}
 	static TYPE signum(TYPE a)
 	{
 		return vsignum(a);
@@ -170,11 +223,107 @@ struct PolarHelper<SIMD<int8_t, WIDTH>>
 	{
 		return vreinterpret<TYPE>(vbsl(vceq(c, d), vmask(qmul(a, b)), vmask(a)));
 	}
+	static TYPE freeze(TYPE a, TYPE f)
+	{
+		return vreinterpret<TYPE>(vbsl(vcgtz(f), vmask(one()), vmask(a)));
+	}
+};
+
+template <int WIDTH>
+struct PolarHelper<SIMD<int16_t, WIDTH>>
+{
+	typedef SIMD<int16_t, WIDTH> TYPE;
+	typedef int PATH;
+	typedef int16_t value_type;
+	static const int SIZE = WIDTH;
+	static value_type get(TYPE a, int i)
+	{
+		return a.v[i];
+	}
+	static void set(TYPE *a, int i, value_type v)
+	{
+		a->v[i] = v;
+	}
+	static TYPE one()
+	{
+		return vdup<TYPE>(1);
+	}
+	static TYPE zero()
+	{
+		return vzero<TYPE>();
+	}
+	static TYPE minus()
+	{
+		return vdup<TYPE>(-1);
+	}
+	static TYPE signum(TYPE a)
+	{
+		return vsignum(a);
+	}
+	static TYPE decide(TYPE a)
+	{
+		return vreinterpret<TYPE>(vorr(vmask(one()), vcltz(a)));
+	}
+	static TYPE qabs(TYPE a)
+	{
+		return vqabs(a);
+	}
+	static TYPE qmin(TYPE a, TYPE b)
+	{
+		return vmin(a, b);
+	}
+	static TYPE qadd(TYPE a, TYPE b)
+	{
+		return vqadd(a, b);
+	}
+	static TYPE qmul(TYPE a, TYPE b)
+	{
+#ifdef __ARM_NEON__
+		return vmul(a, b);
+#else
+		return vsign(a, b);
+#endif
+	}
+	static TYPE prod(TYPE a, TYPE b)
+	{
+#ifdef __ARM_NEON__
+		return vmul(vmul(vsignum(a), vsignum(b)), vmin(vqabs(a), vqabs(b)));
+#else
+		return vsign(vmin(vqabs(a), vqabs(b)), vsign(vsignum(a), b));
+#endif
+	}
+	static TYPE madd(TYPE a, TYPE b, TYPE c)
+	{
+#ifdef __ARM_NEON__
+		return vqadd(vmul(a, vmax(b, vdup<TYPE>(-32767))), c);
+#else
+		return vqadd(vsign(vmax(b, vdup<TYPE>(-32767)), a), c);
+#endif
+	}
+	static TYPE flip(TYPE a, TYPE b, TYPE c, TYPE d)
+	{
+		return vreinterpret<TYPE>(vbsl(vceq(c, d), vmask(qmul(a, b)), vmask(a)));
+	}
+	static TYPE freeze(TYPE a, TYPE f)
+	{
+		return vreinterpret<TYPE>(vbsl(vcgtz(f), vmask(one()), vmask(a)));
+	}
 };
 
 template <>
 struct PolarHelper<int8_t>
 {
+	typedef int PATH;
+	typedef int8_t value_type;
+	static const int SIZE = 1;
+	static value_type get(int8_t a, int)
+	{
+		return a;
+	}
+	static void set(int8_t *a, int, value_type v)
+	{
+		*a = v;
+	}
 	static int8_t one()
 	{
 		return 1;
@@ -183,6 +332,10 @@ struct PolarHelper<int8_t>
 	{
 		return 0;
 	}
+	static int8_t minus()
+	{
+		return -1;
+	}
 	static int8_t signum(int8_t v)
 	{
 		return (v > 0) - (v < 0);
@@ -226,5 +379,111 @@ struct PolarHelper<int8_t>
 	{
 		return c == d ? qmul(a, b) : a;
 	}
+	static int8_t freeze(int8_t a, int8_t f)
+	{
+		return f > 0 ? one() : a;
+	}
+};
+
+template <>
+struct PolarHelper<int16_t>
+{
+	typedef int PATH;
+	typedef int16_t value_type;
+	static const int SIZE = 1;
+	static value_type get(int16_t a, int)
+	{
+		return a;
+	}
+	static void set(int16_t *a, int, value_type v)
+	{
+		*a = v;
+	}
+	static int16_t one()
+	{
+		return 1;
+	}
+	static int16_t zero()
+	{
+		return 0;
+	}
+	static int16_t minus()
+	{
+		return -1;
+	}
+	static int16_t signum(int16_t v)
+	{
+		return (v > 0) - (v < 0);
+	}
+	static int16_t decide(int16_t v)
+	{
+		return (v >= 0) - (v < 0);
+	}
+	template <typename IN>
+	static int16_t quant(IN in)
+	{
+		return std::min<IN>(std::max<IN>(std::nearbyint(in), -32768), 32767);
+	}
+	static int16_t qabs(int16_t a)
+	{
+		return std::abs(std::max<int16_t>(a, -32767));
+	}
+	static int16_t qmin(int16_t a, int16_t b)
+	{
+		return std::min(a, b);
+	}
+	static int16_t qadd(int16_t a, int16_t b)
+	{
+		return std::min<int32_t>(std::max<int32_t>(int32_t(a) + int32_t(b), -32768), 32767);
+	}
+	static int16_t qmul(int16_t a, int16_t b)
+	{
+		// only used for hard decision values anyway
+		return a * b;
+	}
+	static int16_t prod(int16_t a, int16_t b)
+	{
+		return signum(a) * signum(b) * qmin(qabs(a), qabs(b));
+	}
+	static int16_t madd(int16_t a, int16_t b, int16_t c)
+	{
+		return std::min<int32_t>(std::max<int32_t>(int32_t(a) * int32_t(b) + int32_t(c), -32768), 32767);
+	}
+	static int16_t flip(int16_t a, int16_t b, int16_t c, int16_t d)
+	{
+		return c == d ? qmul(a, b) : a;
+	}
+	static int16_t freeze(int16_t a, int16_t f)
+	{
+		return f > 0 ? one() : a;
+	}
 };
 
+template <typename TYPE>
+static inline void polar_trans(TYPE *out, const TYPE *inp, int length)
+{
+	typedef PolarHelper<TYPE> PH;
+	if (length == 1) {
+		*out = *inp;
+		return;
+	}
+	for (int i = 0; i < length; i += 2) {
+		out[i] = PH::qmul(inp[i], inp[i+1]);
+		out[i+1] = inp[i+1];
+	}
+	for (int h = 2; h < length; h *= 2)
+		for (int i = 0; i < length; i += 2 * h)
+			for (int j = i; j < i + h; ++j)
+				out[j] = PH::qmul(out[j], out[j+h]);
+}
+
+// erasure probabilities of the bit channels from the Bhattacharyya recursion over the binary erasure channel
+static inline void polar_erasure(long double *prob, long double pe, int length)
+{
+	if (length == 1) {
+		*prob = pe;
+		return;
+	}
+	polar_erasure(prob, pe * (2-pe), length / 2);
+	polar_erasure(prob + length / 2, pe * pe, length / 2);
+}
@@ -0,0 +1,123 @@
+/*
+Mixed precision successive cancellation decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <int MAX_M, int WIDTH>
+class PolarMixedDecoder
+{
+	static_assert(WIDTH % 2 == 0, "lanes must split into two halves");
+	typedef SIMD<int8_t, WIDTH> NARROW;
+	typedef SIMD<int16_t, WIDTH / 2> WIDE;
+	typedef PolarHelper<WIDE> PH;
+	static const int MAX_N = 1 << MAX_M;
+	PolarDecoder<NARROW, MAX_M> lower;
+	PolarDecoder<WIDE, MAX_M> upper;
+	WIDE soft[2][2*MAX_N];
+	WIDE hard[2][MAX_N];
+	WIDE mesg[2][MAX_N];
+	NARROW input[MAX_N];
+	NARROW result[MAX_N];
+	int shift;
+
+	void left(int level)
+	{
+		int length = 1 << level;
+		for (int h = 0; h < 2; ++h)
+			for (int i = 0; i < length/2; ++i)
+				soft[h][i+length/2] = PH::prod(soft[h][i+length], soft[h][i+length/2+length]);
+	}
+	void right(int level, int pos)
+	{
+		int length = 1 << level;
+		for (int h = 0; h < 2; ++h)
+			for (int i = 0; i < length/2; ++i)
+				soft[h][i+length/2] = PH::madd(hard[h][pos+i], soft[h][i+length], soft[h][i+length/2+length]);
+	}
+	void rate0_right(int level)
+	{
+		int length = 1 << level;
+		for (int h = 0; h < 2; ++h)
+			for (int i = 0; i < length/2; ++i)
+				soft[h][i+length/2] = PH::qadd(soft[h][i+length], soft[h][i+length/2+length]);
+	}
+	void comb(int level, int pos)
+	{
+		int length = 1 << level;
+		for (int h = 0; h < 2; ++h)
+			for (int i = 0; i < length/2; ++i)
+				hard[h][pos+i] = PH::qmul(hard[h][pos+i], hard[h][pos+i+length/2]);
+	}
+	void rate0_comb(int level, int pos)
+	{
+		int length = 1 << level;
+		for (int h = 0; h < 2; ++h)
+			for (int i = 0; i < length/2; ++i)
+				hard[h][pos+i] = hard[h][pos+i+length/2];
+	}
+	const uint8_t *leaf(NARROW *&msg, int pos, const uint8_t *program, int level)
+	{
+		WIDE *lo = mesg[0], *hi = mesg[1];
+		upper.subtree(lo, hard[0] + pos, soft[0] + (1 << level), program, level);
+		program = upper.subtree(hi, hard[1] + pos, soft[1] + (1 << level), program, level);
+		for (int j = 0; j < lo - mesg[0]; ++j)
+			*msg++ = vqmovn(mesg[0][j], mesg[1][j]);
+		return program;
+	}
+	const uint8_t *subtree(NARROW *&msg, int pos, const uint8_t *program, int level)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length; ++i)
+			input[i] = vqmovn(vshr(soft[0][i+length], shift), vshr(soft[1][i+length], shift));
+		program = lower.subtree(msg, result, input, program, level, pos);
+		for (int i = 0; i < length; ++i) {
+			hard[0][pos+i] = vmovl_low(result[i]);
+			hard[1][pos+i] = vmovl_high(result[i]);
+		}
+		return program;
+	}
+public:
+	// min-sum decisions do not depend on the scale, so soft values too large for int8 can be shifted down when narrowed
+	void operator()(NARROW *message, const SIMD<int16_t, WIDTH> *codeword, const uint8_t *program, int boundary = 8, int shift = 0)
+	{
+		this->shift = shift;
+		static const uint8_t rate1[1] = { 4 };
+		const WIDE *halves = reinterpret_cast<const WIDE *>(codeword);
+		NARROW *msg = message;
+		int level = *program, lvl = level, length = 1 << level, pos = 0;
+		assert(level <= MAX_M);
+		lower.prepare(message, program++);
+		for (int i = 0; i < length; ++i) {
+			soft[0][i+length] = halves[2*i];
+			soft[1][i+length] = halves[2*i+1];
+		}
+		if (level <= boundary) {
+			program = subtree(msg, pos, program, level);
+			assert(*program == 255);
+			return;
+		}
+		do {
+			switch (*program) {
+			case 0: case 1: case 2: case 7: case 8: case 9:
+				program = PolarCompiler::step(program, lvl, pos, [this, &msg](int op, int, int lvl, int pos) {
+					switch (op) {
+					case 0: left(lvl); break;
+					case 1: right(lvl, pos); break;
+					case 2: comb(lvl, pos); break;
+					case 7: rate0_right(lvl); break;
+					case 8: rate0_comb(lvl, pos); break;
+					case 9: right(lvl, pos); leaf(msg, pos + (1<<(lvl-1)), rate1, lvl-1); comb(lvl, pos); break;
+					}
+				});
+				break;
+			default: program = leaf(msg, pos, program, lvl); continue;
+			}
+			if (lvl <= boundary)
+				program = subtree(msg, pos, program, lvl);
+		} while (lvl != level);
+		assert(*program == 255);
+	}
+};
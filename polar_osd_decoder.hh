@@ -0,0 +1,128 @@
+/*
+Ordered statistics decoding of short polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+#include <algorithm>
+
+template <typename TYPE, int MAX_M>
+class PolarOSDecoder
+{
+	static_assert(MAX_M <= 8, "codeword must fit into one row vector");
+	typedef PolarHelper<TYPE> PH;
+	typedef SIMD<uint64_t, 4> ROW;
+	static const int MAX_N = 1 << MAX_M;
+	ROW gen[MAX_N];
+	ROW hard, best;
+	float mag[MAX_N];
+	int perm[MAX_N];
+	int basis[MAX_N];
+	TYPE temp[MAX_N];
+	float least;
+
+	static int get(const ROW &row, int j)
+	{
+		return row.v[j>>6] >> (j&63) & 1;
+	}
+	static void set(ROW &row, int j)
+	{
+		row.v[j>>6] |= uint64_t(1) << (j&63);
+	}
+	float cost(ROW cand, float limit)
+	{
+		ROW diff = veor(cand, hard);
+		float sum = 0;
+		for (int w = 0; w < 4; ++w) {
+			for (uint64_t bits = diff.v[w]; bits; bits &= bits - 1) {
+				sum += mag[64*w+__builtin_ctzll(bits)];
+				if (sum >= limit)
+					return sum;
+			}
+		}
+		return sum;
+	}
+	void test(ROW cand)
+	{
+		float sum = cost(cand, least);
+		if (sum < least) {
+			least = sum;
+			best = cand;
+		}
+	}
+	int eliminate(int length, int K)
+	{
+		int rank = 0;
+		for (int j = 0; j < length && rank < K; ++j) {
+			int p = rank;
+			while (p < K && !get(gen[p], j))
+				++p;
+			if (p == K)
+				continue;
+			std::swap(gen[p], gen[rank]);
+			for (int r = 0; r < K; ++r)
+				if (r != rank && get(gen[r], j))
+					gen[r] = veor(gen[r], gen[rank]);
+			basis[rank++] = j;
+		}
+		return rank;
+	}
+public:
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, int order = 2)
+	{
+		assert(level <= MAX_M);
+		assert(order >= 0 && order <= 2);
+		int length = 1 << level;
+		for (int j = 0; j < length; ++j)
+			perm[j] = j;
+		std::sort(perm, perm+length, [codeword](int a, int b){ return PH::qabs(codeword[a]) > PH::qabs(codeword[b]); });
+		hard = vzero<ROW>();
+		for (int j = 0; j < length; ++j) {
+			mag[j] = std::abs(float(codeword[perm[j]]));
+			if (codeword[perm[j]] < 0)
+				set(hard, j);
+		}
+		int K = 0;
+		for (int i = 0; i < length; ++i) {
+			assert(frozen[i] < 2);
+			if (frozen[i])
+				continue;
+			gen[K] = vzero<ROW>();
+			for (int j = 0; j < length; ++j)
+				if ((i & perm[j]) == perm[j])
+					set(gen[K], j);
+			++K;
+		}
+		int rank = eliminate(length, K);
+		assert(rank == K);
+		ROW base = vzero<ROW>();
+		for (int r = 0; r < K; ++r)
+			if (get(hard, basis[r]))
+				base = veor(base, gen[r]);
+		best = base;
+		least = cost(base, INFINITY);
+		int tests = 1;
+		for (int a = K-1; order >= 1 && a >= 0; --a) {
+			if (mag[basis[a]] >= least)
+				break;
+			ROW one = veor(base, gen[a]);
+			test(one);
+			++tests;
+			for (int b = K-1; order >= 2 && b > a; --b) {
+				if (mag[basis[a]] + mag[basis[b]] >= least)
+					break;
+				test(veor(one, gen[b]));
+				++tests;
+			}
+		}
+		for (int j = 0; j < length; ++j)
+			temp[perm[j]] = get(best, j) ? PH::minus() : PH::one();
+		polar_trans(temp, temp, length);
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i])
+				*message++ = temp[i];
+		return tests;
+	}
+};
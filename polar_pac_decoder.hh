@@ -0,0 +1,268 @@
+/*
+List and Fano decoding of polarization-adjusted convolutional codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int POLY>
+class PolarPACPath
+{
+	static_assert(POLY & 1, "convolutional precoder must be rate-1");
+	typedef PolarHelper<TYPE> PH;
+	static const int MAX_N = 1 << MAX_M;
+	TYPE soft[MAX_N];
+	TYPE code[MAX_N];
+	int node[MAX_M];
+
+	const TYPE *get(const TYPE *chan, int level, int lvl, int num)
+	{
+		if (lvl == level)
+			return chan;
+		int length = 1 << lvl;
+		TYPE *out = soft + length;
+		if (node[lvl] == num)
+			return out;
+		const TYPE *inp = get(chan, level, lvl+1, num/2);
+		if (num & 1) {
+			const TYPE *hrd = code + (num-1) * length;
+			polar_trans(out, hrd, length);
+			for (int i = 0; i < length; ++i)
+				out[i] = PH::madd(out[i], inp[i], inp[i+length]);
+		} else {
+			for (int i = 0; i < length; ++i)
+				out[i] = PH::prod(inp[i], inp[i+length]);
+		}
+		node[lvl] = num;
+		return out;
+	}
+public:
+	typename PH::PATH metric;
+	int state;
+
+	static const int MASK = (1 << (31 - __builtin_clz(POLY))) - 1;
+	void init(int level)
+	{
+		for (int l = 0; l < level; ++l)
+			node[l] = -1;
+		metric = 0;
+		state = 0;
+	}
+	TYPE soft_get(const TYPE *chan, int level, int i)
+	{
+		return *get(chan, level, 0, i);
+	}
+	TYPE bit(int u)
+	{
+		return (u ^ __builtin_parity(state & (POLY >> 1))) ? -PH::one() : PH::one();
+	}
+	void decide(int level, int i, int u)
+	{
+		code[i] = bit(u);
+		state = ((state << 1) | u) & MASK;
+		for (int l = 0; l < level; ++l)
+			if (node[l] >= 0 && (node[l] << l) > i)
+				node[l] = -1;
+	}
+	void message(TYPE *mesg, const uint8_t *frozen, int level)
+	{
+		int prev = 0;
+		for (int i = 0; i < (1 << level); ++i) {
+			int u = (code[i] < 0) ^ __builtin_parity(prev & (POLY >> 1));
+			if (!frozen[i])
+				*mesg++ = u ? -PH::one() : PH::one();
+			prev = ((prev << 1) | u) & MASK;
+		}
+	}
+};
+
+template <typename TYPE, int MAX_M, int MAX_L = 32, int POLY = 0155>
+class PolarPACListDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::PATH PATH;
+	typedef PolarPACPath<TYPE, MAX_M, POLY> Path;
+	Path path[MAX_L];
+	int active[MAX_L];
+	int cpath[2*MAX_L];
+	int cbit[2*MAX_L];
+	PATH cmet[2*MAX_L];
+	int order[2*MAX_L];
+	int slot[2*MAX_L];
+	int used[MAX_L];
+
+	static PATH penalty(TYPE sft, TYPE hrd)
+	{
+		return (sft < 0) != (hrd < 0) ? PATH(PH::qabs(sft)) : PATH(0);
+	}
+public:
+	template <typename CHECK>
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, int list_size, CHECK check)
+	{
+		assert(level <= MAX_M);
+		assert(list_size >= 1 && list_size <= MAX_L);
+		int paths = 1;
+		active[0] = 0;
+		path[0].init(level);
+		for (int i = 0; i < (1 << level); ++i) {
+			if (frozen[i]) {
+				for (int p = 0; p < paths; ++p) {
+					Path &pth = path[active[p]];
+					pth.metric += penalty(pth.soft_get(codeword, level, i), pth.bit(0));
+					pth.decide(level, i, 0);
+				}
+				continue;
+			}
+			int num = 0;
+			for (int p = 0; p < paths; ++p) {
+				Path &pth = path[active[p]];
+				TYPE sft = pth.soft_get(codeword, level, i);
+				for (int u = 0; u < 2; ++u) {
+					cpath[num] = active[p];
+					cbit[num] = u;
+					cmet[num++] = pth.metric + penalty(sft, pth.bit(u));
+				}
+			}
+			for (int c = 0; c < num; ++c)
+				order[c] = c;
+			int keep = std::min(num, list_size);
+			std::nth_element(order, order+keep, order+num, [this](int a, int b){ return cmet[a] < cmet[b]; });
+			for (int s = 0; s < MAX_L; ++s)
+				used[s] = 0;
+			for (int c = 0; c < keep; ++c)
+				++used[cpath[order[c]]];
+			int free = 0;
+			for (int c = 0; c < keep; ++c) {
+				int parent = cpath[order[c]];
+				if (used[parent] == 2) {
+					while (used[free])
+						++free;
+					path[free] = path[parent];
+					used[free] = -1;
+					used[parent] = 1;
+					slot[c] = free;
+				} else {
+					slot[c] = parent;
+				}
+			}
+			for (int c = 0; c < keep; ++c) {
+				Path &pth = path[slot[c]];
+				pth.metric = cmet[order[c]];
+				pth.decide(level, i, cbit[order[c]]);
+				active[c] = slot[c];
+			}
+			paths = keep;
+		}
+		for (int p = 0; p < paths; ++p)
+			order[p] = active[p];
+		std::sort(order, order+paths, [this](int a, int b){ return path[a].metric < path[b].metric; });
+		for (int r = 0; r < paths; ++r) {
+			path[order[r]].message(message, frozen, level);
+			if (check(message))
+				return r;
+		}
+		path[order[0]].message(message, frozen, level);
+		return -1;
+	}
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, int list_size)
+	{
+		return (*this)(message, codeword, frozen, level, list_size, [](const TYPE *){ return true; });
+	}
+};
+
+template <typename TYPE, int MAX_M, int POLY = 0155>
+class PolarPACFanoDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	static const int MAX_N = 1 << MAX_M;
+	PolarPACPath<TYPE, MAX_M, POLY> path;
+	long double prob[MAX_N];
+	float bias[MAX_N];
+	float metric[MAX_N];
+	float mu[MAX_N][2];
+	int ubit[MAX_N][2];
+	int state[MAX_N];
+	int choice[MAX_N];
+
+	static float branch(TYPE sft, TYPE hrd)
+	{
+		float x = float(sft) * float(hrd);
+		float pen = x > 0 ? std::log1p(std::exp(-x)) : std::log1p(std::exp(x)) - x;
+		return -pen / std::log(2.f);
+	}
+	void look(const TYPE *codeword, const uint8_t *frozen, int level, int i)
+	{
+		path.state = state[i];
+		TYPE sft = path.soft_get(codeword, level, i);
+		for (int u = 0; u < 2; ++u) {
+			ubit[i][u] = u;
+			mu[i][u] = branch(sft, path.bit(u)) - bias[i];
+		}
+		if (!frozen[i] && mu[i][1] > mu[i][0]) {
+			std::swap(mu[i][0], mu[i][1]);
+			std::swap(ubit[i][0], ubit[i][1]);
+		}
+	}
+public:
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *frozen, int level, int limit, float delta = 1, long double erasure_probability = std::exp(-1.L))
+	{
+		assert(level <= MAX_M);
+		assert(delta > 0);
+		int length = 1 << level;
+		polar_erasure(prob, erasure_probability, length);
+		for (int i = 0; i < length; ++i)
+			bias[i] = std::log2(1 - prob[i] / 2);
+		path.init(level);
+		float thres = 0;
+		int i = 0, steps = 0;
+		state[0] = 0;
+		choice[0] = 0;
+		look(codeword, frozen, level, 0);
+		while (i < length) {
+			if (++steps > limit) {
+				while (i < length) {
+					path.state = state[i];
+					path.decide(level, i, ubit[i][0]);
+					if (++i < length) {
+						state[i] = path.state;
+						look(codeword, frozen, level, i);
+					}
+				}
+				path.message(message, frozen, level);
+				return -1;
+			}
+			float prev = i ? metric[i-1] : 0;
+			float next = prev + mu[i][choice[i]];
+			if (next >= thres) {
+				path.state = state[i];
+				path.decide(level, i, ubit[i][choice[i]]);
+				metric[i] = next;
+				if (prev < thres + delta)
+					while (next >= thres + delta)
+						thres += delta;
+				if (++i < length) {
+					state[i] = path.state;
+					choice[i] = 0;
+					look(codeword, frozen, level, i);
+				}
+				continue;
+			}
+			while (true) {
+				float back = i > 1 ? metric[i-2] : 0;
+				if (!i || back < thres) {
+					thres -= delta;
+					choice[i] = 0;
+					break;
+				}
+				--i;
+				if (!frozen[i] && !choice[i]) {
+					choice[i] = 1;
+					break;
+				}
+			}
+		}
+		path.message(message, frozen, level);
+		return steps;
+	}
+};
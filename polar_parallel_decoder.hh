@@ -0,0 +1,351 @@
+/*
+List parallel successive cancellation list decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int LIST>
+class PolarParallelDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::value_type VALUE;
+	typedef typename PolarHelper<VALUE>::PATH PATH;
+	static const int MAX_N = 1 << MAX_M;
+	static const int WIDTH = PH::SIZE;
+	static const int FRAMES = WIDTH / LIST;
+	static_assert(LIST >= 2 && LIST <= 64 && WIDTH % LIST == 0, "list size must divide SIMD width");
+	static_assert(std::is_same<VALUE, int8_t>::value, "byte shuffles permute int8_t lanes only");
+	typedef SIMD<uint8_t, WIDTH> PERM;
+	TYPE chan[MAX_N];
+	TYPE soft[MAX_N];
+	TYPE hard[MAX_N];
+	VALUE temp[MAX_N];
+	uint8_t frozen[MAX_N];
+	int index[MAX_N];
+	PERM sperm[MAX_M+1], hperm[MAX_M+1];
+	bool sdirty[MAX_M+1], hdirty[MAX_M+1];
+	int weak[WIDTH][LIST];
+	PATH metric[WIDTH];
+	PATH cmet[FRAMES][2*LIST];
+	uint64_t cflip[FRAMES][2*LIST];
+	int cpath[FRAMES][2*LIST];
+	int order[2*LIST];
+	uint64_t flips[WIDTH];
+	int parent[WIDTH];
+	int level;
+
+	static PATH dead()
+	{
+		return std::numeric_limits<PATH>::max() / 2;
+	}
+	static void settle(TYPE *data, int length, PERM perm, bool &dirty)
+	{
+		if (!dirty)
+			return;
+		for (int i = 0; i < length; ++i)
+			data[i] = vshuf(data[i], perm);
+		dirty = false;
+	}
+	TYPE *soft_get(int lvl)
+	{
+		if (lvl == level)
+			return chan;
+		TYPE *sft = soft + (1 << lvl);
+		settle(sft, 1 << lvl, sperm[lvl], sdirty[lvl]);
+		return sft;
+	}
+	TYPE *soft_put(int lvl)
+	{
+		sdirty[lvl] = false;
+		return soft + (1 << lvl);
+	}
+	TYPE *hard_get(int lvl, int off)
+	{
+		settle(hard + off, 1 << lvl, hperm[lvl], hdirty[lvl]);
+		return hard + off;
+	}
+	static VALUE val(const TYPE *sft, int i, int k)
+	{
+		return PH::get(sft[i], k);
+	}
+	void left(int lvl)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl);
+		TYPE *out = soft_put(lvl-1);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::prod(inp[i], inp[i+length/2]);
+	}
+	void right(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl);
+		const TYPE *hrd = hard + off;
+		TYPE *out = soft_put(lvl-1);
+		hdirty[lvl-1] = false;
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::madd(hrd[i], inp[i], inp[i+length/2]);
+	}
+	void rate0_right(int lvl)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl);
+		TYPE *out = soft_put(lvl-1);
+		for (int i = 0; i < length/2; ++i) {
+			TYPE sft = PH::prod(inp[i], inp[i+length/2]);
+			for (int k = 0; k < WIDTH; ++k)
+				if (PH::get(sft, k) < 0)
+					metric[k] -= PH::get(sft, k);
+			out[i] = PH::qadd(inp[i], inp[i+length/2]);
+		}
+	}
+	void comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		TYPE *hrd = hard_get(lvl-1, off);
+		for (int i = 0; i < length/2; ++i)
+			hrd[i] = PH::qmul(hrd[i], hrd[i+length/2]);
+	}
+	void rate0_comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		TYPE *hrd = hard + off;
+		for (int i = 0; i < length/2; ++i)
+			hrd[i] = hrd[i+length/2];
+	}
+	void weakest(int *wk, const TYPE *sft, int k, int length, int depth)
+	{
+		for (int i = 0; i < length; ++i)
+			index[i] = i;
+		std::partial_sort(index, index+depth, index+length, [sft, k](int a, int b){ return std::abs(val(sft, a, k)) < std::abs(val(sft, b, k)); });
+		for (int i = 0; i < depth; ++i)
+			wk[i] = index[i];
+	}
+	void prune(int *num)
+	{
+		for (int f = 0; f < FRAMES; ++f) {
+			if (num[f] <= LIST)
+				continue;
+			for (int i = 0; i < num[f]; ++i)
+				order[i] = i;
+			std::nth_element(order, order+LIST, order+num[f], [this, f](int a, int b){ return cmet[f][a] < cmet[f][b]; });
+			PATH met[LIST];
+			uint64_t flp[LIST];
+			int pth[LIST];
+			for (int i = 0; i < LIST; ++i) {
+				met[i] = cmet[f][order[i]];
+				flp[i] = cflip[f][order[i]];
+				pth[i] = cpath[f][order[i]];
+			}
+			for (int i = 0; i < LIST; ++i) {
+				cmet[f][i] = met[i];
+				cflip[f][i] = flp[i];
+				cpath[f][i] = pth[i];
+			}
+			num[f] = LIST;
+		}
+	}
+	void branch()
+	{
+		PERM perm;
+		for (int f = 0; f < FRAMES; ++f) {
+			for (int i = 0; i < LIST; ++i) {
+				int k = f * LIST + i;
+				parent[k] = f * LIST + cpath[f][i];
+				perm.v[k] = parent[k];
+				metric[k] = cmet[f][i];
+				flips[k] = cflip[f][i];
+			}
+		}
+		for (int l = 0; l < level; ++l) {
+			sperm[l] = sdirty[l] ? vshuf(sperm[l], perm) : perm;
+			hperm[l] = hdirty[l] ? vshuf(hperm[l], perm) : perm;
+			sdirty[l] = hdirty[l] = true;
+		}
+	}
+	void store(int lvl, int off, const TYPE *sft, int depth)
+	{
+		int length = 1 << lvl;
+		for (int k = 0; k < WIDTH; ++k) {
+			int p = parent[k];
+			for (int i = 0; i < length; ++i)
+				temp[i] = val(sft, i, p) < 0 ? -1 : 1;
+			for (int t = 0; t < depth; ++t)
+				if (flips[k] >> t & 1)
+					temp[weak[p][t]] = -temp[weak[p][t]];
+			for (int i = 0; i < length; ++i)
+				PH::set(hard+off+i, k, temp[i]);
+		}
+	}
+	void rate0(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl);
+		for (int i = 0; i < length; ++i) {
+			for (int k = 0; k < WIDTH; ++k)
+				if (val(sft, i, k) < 0)
+					metric[k] -= val(sft, i, k);
+			hard[off+i] = PH::one();
+		}
+	}
+	void rate1(int lvl, int off)
+	{
+		int length = 1 << lvl, num[FRAMES];
+		int depth = std::min(LIST-1, length);
+		const TYPE *sft = soft_get(lvl);
+		for (int f = 0; f < FRAMES; ++f) {
+			num[f] = 0;
+			for (int p = 0; p < LIST; ++p) {
+				int k = f * LIST + p;
+				weakest(weak[k], sft, k, length, depth);
+				cpath[f][num[f]] = p;
+				cflip[f][num[f]] = 0;
+				cmet[f][num[f]++] = metric[k];
+			}
+		}
+		for (int t = 0; t < depth; ++t) {
+			for (int f = 0; f < FRAMES; ++f) {
+				for (int c = 0, cnt = num[f]; c < cnt; ++c) {
+					int k = f * LIST + cpath[f][c];
+					cpath[f][num[f]] = cpath[f][c];
+					cflip[f][num[f]] = cflip[f][c] | 1ULL << t;
+					cmet[f][num[f]++] = cmet[f][c] + std::abs(val(sft, weak[k][t], k));
+				}
+			}
+			prune(num);
+		}
+		branch();
+		store(lvl, off, sft, depth);
+	}
+	void rep(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl);
+		for (int f = 0; f < FRAMES; ++f) {
+			for (int p = 0; p < LIST; ++p) {
+				int k = f * LIST + p;
+				PATH pos = 0, neg = 0;
+				for (int i = 0; i < length; ++i) {
+					if (val(sft, i, k) < 0)
+						pos -= val(sft, i, k);
+					else
+						neg += val(sft, i, k);
+				}
+				cpath[f][2*p] = p;
+				cflip[f][2*p] = 0;
+				cmet[f][2*p] = metric[k] + pos;
+				cpath[f][2*p+1] = p;
+				cflip[f][2*p+1] = 1;
+				cmet[f][2*p+1] = metric[k] + neg;
+			}
+		}
+		int num[FRAMES];
+		for (int f = 0; f < FRAMES; ++f)
+			num[f] = 2 * LIST;
+		prune(num);
+		branch();
+		for (int k = 0; k < WIDTH; ++k)
+			for (int i = 0; i < length; ++i)
+				PH::set(hard+off+i, k, flips[k] ? -1 : 1);
+	}
+	void spc(int lvl, int off)
+	{
+		int length = 1 << lvl, num[FRAMES];
+		int depth = std::min(LIST, length);
+		const TYPE *sft = soft_get(lvl);
+		for (int f = 0; f < FRAMES; ++f) {
+			num[f] = 0;
+			for (int p = 0; p < LIST; ++p) {
+				int k = f * LIST + p;
+				weakest(weak[k], sft, k, length, depth);
+				uint64_t odd = 0;
+				for (int i = 0; i < length; ++i)
+					odd ^= val(sft, i, k) < 0;
+				cpath[f][num[f]] = p;
+				cflip[f][num[f]] = odd;
+				cmet[f][num[f]++] = metric[k] + (odd ? PATH(std::abs(val(sft, weak[k][0], k))) : PATH(0));
+			}
+		}
+		for (int t = 1; t < depth; ++t) {
+			for (int f = 0; f < FRAMES; ++f) {
+				for (int c = 0, cnt = num[f]; c < cnt; ++c) {
+					int k = f * LIST + cpath[f][c];
+					PATH least = std::abs(val(sft, weak[k][0], k));
+					PATH pen = std::abs(val(sft, weak[k][t], k));
+					cpath[f][num[f]] = cpath[f][c];
+					cflip[f][num[f]] = (cflip[f][c] ^ 1) | 1ULL << t;
+					cmet[f][num[f]++] = cmet[f][c] + pen + (cflip[f][c] & 1 ? -least : least);
+				}
+			}
+			prune(num);
+		}
+		branch();
+		store(lvl, off, sft, depth);
+	}
+	void extract(VALUE *message, int lane)
+	{
+		int length = 1 << level;
+		for (int i = 0; i < length; ++i)
+			temp[i] = PH::get(hard[i], lane);
+		polar_trans(temp, temp, length);
+		for (int i = 0; i < length; ++i)
+			if (!frozen[i])
+				*message++ = temp[i];
+	}
+public:
+	template <typename CHECK>
+	void operator()(int *rank, VALUE *message, const VALUE *codeword, const uint8_t *program, CHECK check)
+	{
+		level = *program;
+		assert(level <= MAX_M);
+		int length = 1 << level, count = 0;
+		PolarCompiler::freeze(frozen, program);
+		for (int i = 0; i < length; ++i)
+			count += !frozen[i];
+		for (int i = 0; i < length; ++i)
+			for (int k = 0; k < WIDTH; ++k)
+				PH::set(chan+i, k, codeword[length*(k/LIST)+i]);
+		for (int k = 0; k < WIDTH; ++k)
+			metric[k] = k % LIST ? dead() : 0;
+		for (int l = 0; l < level; ++l)
+			sdirty[l] = hdirty[l] = false;
+		PolarCompiler::walk(program, [this](int op, int, int lvl, int off) {
+			switch (op) {
+			case 0: left(lvl); break;
+			case 1: right(lvl, off); break;
+			case 2: comb(lvl, off); break;
+			case 3: rate0(lvl, off); break;
+			case 4: rate1(lvl, off); break;
+			case 5: rep(lvl, off); break;
+			case 6: spc(lvl, off); break;
+			case 7: rate0_right(lvl); break;
+			case 8: rate0_comb(lvl, off); break;
+			case 9: right(lvl, off); rate1(lvl-1, off+(1<<(lvl-1))); comb(lvl, off); break;
+			default: assert(false);
+			}
+		});
+		for (int f = 0; f < FRAMES; ++f) {
+			VALUE *msg = message + count * f;
+			for (int p = 0; p < LIST; ++p)
+				order[p] = f * LIST + p;
+			std::sort(order, order+LIST, [this](int a, int b){ return metric[a] < metric[b]; });
+			rank[f] = -1;
+			for (int r = 0; r < LIST && metric[order[r]] < dead(); ++r) {
+				extract(msg, order[r]);
+				if (check(msg)) {
+					rank[f] = r;
+					break;
+				}
+			}
+			if (rank[f] < 0)
+				extract(msg, order[0]);
+		}
+	}
+	void operator()(VALUE *message, const VALUE *codeword, const uint8_t *program)
+	{
+		int rank[FRAMES];
+		(*this)(rank, message, codeword, program, [](const VALUE *){ return true; });
+	}
+};
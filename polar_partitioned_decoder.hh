@@ -0,0 +1,219 @@
+/*
+Partitioned successive cancellation list decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int MAX_Q, int MAX_L = 32, int PERIOD = 5>
+class PolarPartitionedDecoder
+{
+	static_assert(MAX_Q >= 1 && MAX_Q <= MAX_M, "partition level out of range");
+	typedef PolarHelper<TYPE> PH;
+	static const int MAX_N = 1 << MAX_M;
+	static const int MAX_S = 1 << MAX_Q;
+	PolarListDecoder<TYPE, MAX_Q, MAX_L, PERIOD> list;
+	TYPE soft[MAX_N];
+	TYPE hard[MAX_N];
+	TYPE temp[MAX_N];
+	TYPE part[MAX_S];
+	uint8_t prog[3*MAX_S];
+	uint8_t frozen[MAX_S];
+	uint8_t fixed[MAX_N];
+	const TYPE *chan;
+	int level, split, limit, known, used, state;
+
+	static bool decisions(const uint8_t *program, int lvl, int off)
+	{
+		bool found = false;
+		while (*program != 255)
+			program = PolarCompiler::step(program, lvl, off, [&found](int op, int, int, int){
+				found |= op == 4 || op == 5 || op == 6 || op == 9;
+			});
+		return found;
+	}
+	const TYPE *soft_get(int lvl)
+	{
+		if (lvl == level)
+			return chan;
+		return soft + (1 << lvl);
+	}
+	void left(int lvl)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl);
+		TYPE *out = soft + (1 << (lvl-1));
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::prod(inp[i], inp[i+length/2]);
+	}
+	void right(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl);
+		const TYPE *hrd = hard + off;
+		TYPE *out = soft + (1 << (lvl-1));
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::madd(hrd[i], inp[i], inp[i+length/2]);
+	}
+	void rate0_right(int lvl)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl);
+		TYPE *out = soft + (1 << (lvl-1));
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::qadd(inp[i], inp[i+length/2]);
+	}
+	void comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		TYPE *hrd = hard + off;
+		for (int i = 0; i < length/2; ++i)
+			hrd[i] = PH::qmul(hrd[i], hrd[i+length/2]);
+	}
+	void rate0_comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		TYPE *hrd = hard + off;
+		for (int i = 0; i < length/2; ++i)
+			hrd[i] = hrd[i+length/2];
+	}
+	void rate0(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		for (int i = 0; i < length; ++i)
+			hard[off+i] = PH::one();
+	}
+	int rate1(int lvl, int off, TYPE *msg)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl);
+		for (int i = 0; i < length; ++i)
+			hard[off+i] = PH::decide(sft[i]);
+		polar_trans(msg, hard+off, length);
+		return length;
+	}
+	int rep(int lvl, int off, TYPE *msg)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl);
+		TYPE sum = sft[0];
+		for (int i = 1; i < length; ++i)
+			sum = PH::qadd(sum, sft[i]);
+		*msg = PH::decide(sum);
+		for (int i = 0; i < length; ++i)
+			hard[off+i] = *msg;
+		return 1;
+	}
+	int spc(int lvl, int off, TYPE *msg)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl);
+		TYPE *hrd = hard + off;
+		int weak = 0;
+		TYPE parity = PH::one();
+		for (int i = 0; i < length; ++i) {
+			hrd[i] = PH::decide(sft[i]);
+			parity = PH::qmul(parity, hrd[i]);
+			if (PH::qabs(sft[i]) < PH::qabs(sft[weak]))
+				weak = i;
+		}
+		hrd[weak] = PH::qmul(hrd[weak], parity);
+		polar_trans(temp, hrd, length);
+		for (int i = 0; i < length-1; ++i)
+			msg[i] = temp[i+1];
+		return length-1;
+	}
+	template <typename CHECK>
+	const uint8_t *partition(TYPE *message, TYPE *&msg, const uint8_t *program, int off, CHECK check)
+	{
+		int lvl = split, pos = 0, len = 0;
+		prog[len++] = split;
+		while (true) {
+			int op = *program;
+			if (lvl == split && (op == 1 || op == 2 || op == 8 || op == 9 || op == 255))
+				break;
+			const uint8_t *next = PolarCompiler::step(program, lvl, pos, [](int, int, int, int){});
+			assert(len + (next - program) < 3*MAX_S);
+			while (program != next)
+				prog[len++] = *program++;
+		}
+		prog[len] = 255;
+		PolarCompiler::freeze(frozen, prog);
+		int length = 1 << split, count = 0;
+		for (int i = 0; i < length; ++i)
+			count += !frozen[i];
+		// the parity register of the dynamic frozen bits catches up with the messages decided so far
+		for (; known < off; ++known)
+			if (!fixed[known])
+				state ^= (message[used++] < 0) << known % PERIOD;
+		if (decisions(program, lvl, off)) {
+			list(part, soft_get(split), prog, limit, [](const TYPE *){ return true; }, off, state);
+		} else {
+			list(part, soft_get(split), prog, limit, [&](const TYPE *m){
+				for (int i = 0; i < count; ++i)
+					msg[i] = m[i];
+				return check(message);
+			}, off, state);
+		}
+		TYPE *hrd = hard + off;
+		for (int i = 0, j = 0, reg = state; i < length; ++i) {
+			if (!frozen[i]) {
+				hrd[i] = part[j++];
+				reg ^= (hrd[i] < 0) << (off+i) % PERIOD;
+			} else {
+				hrd[i] = frozen[i] == 2 && reg >> (off+i) % PERIOD & 1 ? -PH::one() : PH::one();
+			}
+		}
+		polar_trans(hrd, hrd, length);
+		for (int i = 0; i < count; ++i)
+			msg[i] = part[i];
+		msg += count;
+		return program;
+	}
+public:
+	template <typename CHECK>
+	void operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, int partitions, int list_size, CHECK check)
+	{
+		assert(list_size >= 1 && list_size <= MAX_L);
+		PolarCompiler::freeze(fixed, program);
+		known = used = state = 0;
+		level = *program++;
+		assert(level <= MAX_M);
+		split = level;
+		for (int p = partitions; p > 1; p /= 2)
+			--split;
+		assert(partitions == 1 << (level - split));
+		assert(split >= 1 && split <= MAX_Q);
+		chan = codeword;
+		limit = list_size;
+		TYPE *msg = message;
+		int lvl = level, off = 0;
+		if (lvl == split)
+			program = partition(message, msg, program, off, check);
+		while (*program != 255) {
+			program = PolarCompiler::step(program, lvl, off, [this, &msg](int op, int, int lvl, int off) {
+				switch (op) {
+				case 0: left(lvl); break;
+				case 1: right(lvl, off); break;
+				case 2: comb(lvl, off); break;
+				case 3: rate0(lvl, off); break;
+				case 4: msg += rate1(lvl, off, msg); break;
+				case 5: msg += rep(lvl, off, msg); break;
+				case 6: msg += spc(lvl, off, msg); break;
+				case 7: rate0_right(lvl); break;
+				case 8: rate0_comb(lvl, off); break;
+				case 9: right(lvl, off); msg += rate1(lvl-1, off+(1<<(lvl-1)), msg); comb(lvl, off); break;
+				default: assert(false);
+				}
+			});
+			if (lvl == split)
+				program = partition(message, msg, program, off, check);
+		}
+		assert(lvl == level);
+	}
+	void operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, int partitions, int list_size)
+	{
+		(*this)(message, codeword, program, partitions, list_size, [](const TYPE *){ return true; });
+	}
+};
@@ -0,0 +1,155 @@
+/*
+Soft cancellation decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M>
+class PolarScanDecoder
+{
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::value_type VALUE;
+	static const int MAX_N = 1 << MAX_M;
+	static const int WIDTH = PH::SIZE;
+	TYPE soft[MAX_N];
+	TYPE beta[(MAX_M+1)*MAX_N];
+	TYPE temp[MAX_N];
+	const TYPE *chan;
+	int level;
+
+	static VALUE certain()
+	{
+		if (std::is_floating_point<VALUE>::value)
+			return 1 << 16;
+		return std::numeric_limits<VALUE>::max();
+	}
+	const TYPE *alpha(int lvl)
+	{
+		if (lvl == level)
+			return chan;
+		return soft + (1 << lvl);
+	}
+	TYPE *belief(int lvl, int off)
+	{
+		return beta + lvl * MAX_N + off;
+	}
+	void left(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = alpha(lvl);
+		const TYPE *rgt = belief(lvl-1, off+length/2);
+		TYPE *out = soft + (1 << (lvl-1));
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::prod(inp[i], PH::qadd(inp[i+length/2], rgt[i]));
+	}
+	void right(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = alpha(lvl);
+		const TYPE *lft = belief(lvl-1, off);
+		TYPE *out = soft + (1 << (lvl-1));
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::qadd(PH::prod(inp[i], lft[i]), inp[i+length/2]);
+	}
+	void rate0_right(int lvl)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = alpha(lvl);
+		TYPE *out = soft + (1 << (lvl-1));
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::qadd(inp[i], inp[i+length/2]);
+	}
+	void comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = alpha(lvl);
+		const TYPE *lft = belief(lvl-1, off);
+		const TYPE *rgt = belief(lvl-1, off+length/2);
+		TYPE *out = belief(lvl, off);
+		for (int i = 0; i < length/2; ++i) {
+			out[i] = PH::prod(lft[i], PH::qadd(rgt[i], inp[i+length/2]));
+			out[i+length/2] = PH::qadd(PH::prod(lft[i], inp[i]), rgt[i]);
+		}
+	}
+	void rate0_comb(int lvl, int off)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = alpha(lvl);
+		const TYPE *rgt = belief(lvl-1, off+length/2);
+		TYPE *out = belief(lvl, off);
+		for (int i = 0; i < length/2; ++i) {
+			out[i] = PH::qadd(rgt[i], inp[i+length/2]);
+			out[i+length/2] = PH::qadd(inp[i], rgt[i]);
+		}
+	}
+	template <typename OP>
+	void others(int lvl, int off, OP op)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = alpha(lvl);
+		TYPE *out = belief(lvl, off);
+		temp[1] = inp[0];
+		for (int i = 2; i < length; ++i)
+			temp[i] = op(temp[i-1], inp[i-1]);
+		TYPE acc = inp[length-1];
+		out[length-1] = temp[length-1];
+		for (int i = length-2; i > 0; --i) {
+			out[i] = op(temp[i], acc);
+			acc = op(acc, inp[i]);
+		}
+		out[0] = acc;
+	}
+	void rep(int lvl, int off)
+	{
+		others(lvl, off, PH::qadd);
+	}
+	void spc(int lvl, int off)
+	{
+		others(lvl, off, PH::prod);
+	}
+	void init(const uint8_t *program)
+	{
+		TYPE sure;
+		for (int k = 0; k < WIDTH; ++k)
+			PH::set(&sure, k, certain());
+		for (int l = 0; l <= level; ++l)
+			for (int i = 0; i < (1 << level); ++i)
+				beta[l*MAX_N+i] = PH::zero();
+		PolarCompiler::walk(program, [this, sure](int op, int, int lvl, int off) {
+			assert(op <= 9);
+			if (op == 3)
+				for (int i = 0; i < (1 << lvl); ++i)
+					beta[lvl*MAX_N+off+i] = sure;
+		});
+	}
+public:
+	void operator()(TYPE *extrinsic, const TYPE *codeword, const uint8_t *program, int iterations)
+	{
+		assert(iterations >= 1);
+		level = *program;
+		assert(level <= MAX_M);
+		chan = codeword;
+		init(program);
+		for (int iter = 0; iter < iterations; ++iter) {
+			PolarCompiler::walk(program, [this](int op, int, int lvl, int off) {
+				switch (op) {
+				case 0: left(lvl, off); break;
+				case 1: right(lvl, off); break;
+				case 2: comb(lvl, off); break;
+				case 3: break;
+				case 4: break;
+				case 5: rep(lvl, off); break;
+				case 6: spc(lvl, off); break;
+				case 7: rate0_right(lvl); break;
+				case 8: rate0_comb(lvl, off); break;
+				case 9: comb(lvl, off); break;
+				default: assert(false);
+				}
+			});
+		}
+		for (int i = 0; i < (1 << level); ++i)
+			extrinsic[i] = beta[level*MAX_N+i];
+	}
+};
@@ -0,0 +1,392 @@
+/*
+Successive cancellation stack decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#pragma once
+
+template <typename TYPE, int MAX_M, int MAX_S = 256>
+class PolarStackDecoder
+{
+	static_assert(MAX_S >= 4, "stack must hold all children of a node");
+	typedef PolarHelper<TYPE> PH;
+	typedef typename PH::PATH PATH;
+	static const int MAX_N = 1 << MAX_M;
+	static const int MAX_C = 8;
+	struct Path
+	{
+		const uint8_t *program;
+		PATH metric;
+		int lvl, off, count;
+	};
+	TYPE soft[MAX_S*MAX_N];
+	TYPE hard[2*MAX_S*MAX_N];
+	TYPE mesg[MAX_S*MAX_N];
+	TYPE temp[MAX_N];
+	int index[MAX_N];
+	int visits[MAX_N];
+	Path path[MAX_S];
+	int stack[MAX_S], spare[MAX_S];
+	int sidx[MAX_M][MAX_S], scnt[MAX_M][MAX_S], sfree[MAX_M][MAX_S], stop[MAX_M];
+	int hidx[MAX_M][MAX_S], hcnt[MAX_M][MAX_S], hfree[MAX_M][MAX_S], htop[MAX_M];
+	int weak[3], cmask[MAX_C], cpath[MAX_C];
+	PATH cmet[MAX_C];
+	const TYPE *chan;
+	int level, limit, depth, spares, bound;
+
+	const TYPE *soft_get(int lvl, int p)
+	{
+		if (lvl == level)
+			return chan;
+		return soft + MAX_S * ((1<<lvl)-1) + (sidx[lvl][p] << lvl);
+	}
+	TYPE *soft_put(int lvl, int p)
+	{
+		int &idx = sidx[lvl][p];
+		if (scnt[lvl][idx] > 1) {
+			--scnt[lvl][idx];
+			idx = sfree[lvl][--stop[lvl]];
+			scnt[lvl][idx] = 1;
+		}
+		return soft + MAX_S * ((1<<lvl)-1) + (idx << lvl);
+	}
+	const TYPE *hard_get(int lvl, int p)
+	{
+		return hard + MAX_S * ((2<<lvl)-2) + (hidx[lvl][p] << (lvl+1));
+	}
+	TYPE *hard_put(int lvl, int p, int keep)
+	{
+		int &idx = hidx[lvl][p];
+		TYPE *base = hard + MAX_S * ((2<<lvl)-2);
+		if (hcnt[lvl][idx] > 1) {
+			TYPE *old = base + (idx << (lvl+1));
+			--hcnt[lvl][idx];
+			idx = hfree[lvl][--htop[lvl]];
+			hcnt[lvl][idx] = 1;
+			for (int i = 0; i < keep; ++i)
+				base[(idx << (lvl+1))+i] = old[i];
+		}
+		return base + (idx << (lvl+1));
+	}
+	void fork(int dst, int src)
+	{
+		path[dst] = path[src];
+		for (int l = 0; l < level; ++l) {
+			++scnt[l][sidx[l][dst] = sidx[l][src]];
+			++hcnt[l][hidx[l][dst] = hidx[l][src]];
+		}
+		for (int i = 0; i < path[src].count; ++i)
+			mesg[MAX_N*dst+i] = mesg[MAX_N*src+i];
+	}
+	void release(int p)
+	{
+		for (int l = 0; l < level; ++l) {
+			if (!--scnt[l][sidx[l][p]])
+				sfree[l][stop[l]++] = sidx[l][p];
+			if (!--hcnt[l][hidx[l][p]])
+				hfree[l][htop[l]++] = hidx[l][p];
+		}
+		spare[spares++] = p;
+	}
+	int pop()
+	{
+		int best = 0;
+		for (int i = 1; i < depth; ++i)
+			if (path[stack[i]].metric < path[stack[best]].metric)
+				best = i;
+		int p = stack[best];
+		stack[best] = stack[--depth];
+		return p;
+	}
+	int alloc(PATH metric)
+	{
+		if (spares)
+			return spare[--spares];
+		for (int i = 0; i < depth;) {
+			int q = stack[i];
+			if (path[q].count <= bound || visits[path[q].count] >= limit) {
+				stack[i] = stack[--depth];
+				release(q);
+			} else {
+				++i;
+			}
+		}
+		if (spares)
+			return spare[--spares];
+		int worst = 0;
+		for (int i = 1; i < depth; ++i)
+			if (path[stack[i]].metric > path[stack[worst]].metric)
+				worst = i;
+		if (!depth || path[stack[worst]].metric <= metric)
+			return -1;
+		int p = stack[worst];
+		stack[worst] = stack[--depth];
+		release(p);
+		return spare[--spares];
+	}
+	void store(int lvl, int off, int p)
+	{
+		if (lvl == level)
+			return;
+		int length = 1 << lvl, side = (off >> lvl) & 1;
+		TYPE *hrd = hard_put(lvl, p, side * length) + side * length;
+		for (int i = 0; i < length; ++i)
+			hrd[i] = temp[i];
+	}
+	void left(int lvl, int p)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl, p);
+		TYPE *out = soft_put(lvl-1, p);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::prod(inp[i], inp[i+length/2]);
+	}
+	void right(int lvl, int p)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl, p);
+		const TYPE *hrd = hard_get(lvl-1, p);
+		TYPE *out = soft_put(lvl-1, p);
+		for (int i = 0; i < length/2; ++i)
+			out[i] = PH::madd(hrd[i], inp[i], inp[i+length/2]);
+	}
+	void rate0_right(int lvl, int p)
+	{
+		int length = 1 << lvl;
+		const TYPE *inp = soft_get(lvl, p);
+		TYPE *out = soft_put(lvl-1, p);
+		PATH pen = 0;
+		for (int i = 0; i < length/2; ++i) {
+			TYPE sft = PH::prod(inp[i], inp[i+length/2]);
+			if (sft < 0)
+				pen -= sft;
+			out[i] = PH::qadd(inp[i], inp[i+length/2]);
+		}
+		path[p].metric += pen;
+	}
+	void comb(int lvl, int off, int p)
+	{
+		if (lvl == level)
+			return;
+		int length = 1 << lvl, side = (off >> lvl) & 1;
+		const TYPE *inp = hard_get(lvl-1, p);
+		TYPE *out = hard_put(lvl, p, side * length) + side * length;
+		for (int i = 0; i < length/2; ++i) {
+			out[i] = PH::qmul(inp[i], inp[i+length/2]);
+			out[i+length/2] = inp[i+length/2];
+		}
+	}
+	void rate0_comb(int lvl, int off, int p)
+	{
+		if (lvl == level)
+			return;
+		int length = 1 << lvl, side = (off >> lvl) & 1;
+		const TYPE *inp = hard_get(lvl-1, p);
+		TYPE *out = hard_put(lvl, p, side * length) + side * length;
+		for (int i = 0; i < length/2; ++i)
+			out[i] = out[i+length/2] = inp[i+length/2];
+	}
+	void rate0(int lvl, int off, int p)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl, p);
+		PATH pen = 0;
+		for (int i = 0; i < length; ++i) {
+			if (sft[i] < 0)
+				pen -= sft[i];
+			temp[i] = PH::one();
+		}
+		path[p].metric += pen;
+		store(lvl, off, p);
+	}
+	int candidates(const TYPE *sft, int length, int num, int parity)
+	{
+		for (int i = 0; i < length; ++i)
+			index[i] = i;
+		std::partial_sort(index, index+num, index+length, [sft](int a, int b){ return PH::qabs(sft[a]) < PH::qabs(sft[b]); });
+		for (int i = 0; i < num; ++i)
+			weak[i] = index[i];
+		int cnt = 0;
+		for (int mask = 0; mask < 1 << num; ++mask) {
+			if (parity >= 0 && (__builtin_popcount(mask) & 1) != parity)
+				continue;
+			PATH pen = 0;
+			for (int i = 0; i < num; ++i)
+				if (mask >> i & 1)
+					pen += PH::qabs(sft[weak[i]]);
+			cmask[cnt] = mask;
+			cmet[cnt++] = pen;
+		}
+		return cnt;
+	}
+	int rep_candidates(const TYPE *sft, int length)
+	{
+		PATH pos = 0, neg = 0;
+		for (int i = 0; i < length; ++i) {
+			if (sft[i] < 0)
+				pos -= sft[i];
+			else
+				neg += sft[i];
+		}
+		cmask[0] = pos > neg;
+		cmet[0] = std::min(pos, neg);
+		cmask[1] = pos <= neg;
+		cmet[1] = std::max(pos, neg);
+		return 2;
+	}
+	void apply(int p, int op, int lvl, int off, int mask)
+	{
+		int length = 1 << lvl;
+		const TYPE *sft = soft_get(lvl, p);
+		TYPE *msg = mesg + MAX_N * p + path[p].count;
+		if (op == 5) {
+			for (int i = 0; i < length; ++i)
+				temp[i] = mask ? -PH::one() : PH::one();
+			store(lvl, off, p);
+			msg[0] = temp[0];
+			path[p].count += 1;
+			return;
+		}
+		for (int i = 0; i < length; ++i)
+			temp[i] = PH::decide(sft[i]);
+		for (int i = 0; mask >> i; ++i)
+			if (mask >> i & 1)
+				temp[weak[i]] = -temp[weak[i]];
+		store(lvl, off, p);
+		polar_trans(temp, temp, length);
+		int first = op == 6;
+		for (int i = first; i < length; ++i)
+			msg[i-first] = temp[i];
+		path[p].count += length - first;
+	}
+	void decide(int p)
+	{
+		Path &cur = path[p];
+		if (cur.count <= bound || visits[cur.count] >= limit) {
+			release(p);
+			return;
+		}
+		if (++visits[cur.count] == limit)
+			bound = std::max(bound, cur.count);
+		int op = *cur.program, lvl = cur.lvl, off = cur.off;
+		if (op == 9) {
+			right(lvl+1, p);
+			off += 1 << lvl;
+		}
+		int length = 1 << lvl, num;
+		const TYPE *sft = soft_get(lvl, p);
+		if (op == 5) {
+			num = rep_candidates(sft, length);
+		} else if (op == 6) {
+			int odd = 0;
+			for (int i = 0; i < length; ++i)
+				odd ^= sft[i] < 0;
+			num = candidates(sft, length, std::min(3, length), odd);
+		} else {
+			num = candidates(sft, length, std::min(2, length), -1);
+		}
+		for (int c = 0; c < num; ++c)
+			cmet[c] += cur.metric;
+		int mask = cmask[0], cnt = 0;
+		PATH met = cmet[0];
+		for (int c = 1; c < num; ++c) {
+			int q = alloc(cmet[c]);
+			if (q < 0)
+				continue;
+			fork(q, p);
+			cpath[cnt] = q;
+			cmask[cnt] = cmask[c];
+			cmet[cnt++] = cmet[c];
+		}
+		cpath[cnt] = p;
+		cmask[cnt] = mask;
+		cmet[cnt++] = met;
+		for (int c = 0; c < cnt; ++c) {
+			int q = cpath[c];
+			apply(q, op, lvl, off, cmask[c]);
+			path[q].metric = cmet[c];
+			++path[q].program;
+			if (op == 9) {
+				path[q].lvl = lvl + 1;
+				comb(lvl + 1, path[q].off, q);
+			}
+			stack[depth++] = q;
+		}
+	}
+public:
+	template <typename CHECK>
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, int list_size, CHECK check)
+	{
+		assert(list_size >= 1);
+		level = *program++;
+		assert(level <= MAX_M);
+		chan = codeword;
+		limit = list_size;
+		bound = -1;
+		int length = 1 << level;
+		for (int i = 0; i < length; ++i)
+			visits[i] = 0;
+		for (int l = 0; l < level; ++l) {
+			sidx[l][0] = hidx[l][0] = 0;
+			scnt[l][0] = hcnt[l][0] = 1;
+			stop[l] = htop[l] = 0;
+			for (int i = MAX_S-1; i > 0; --i) {
+				sfree[l][stop[l]++] = i;
+				hfree[l][htop[l]++] = i;
+			}
+		}
+		spares = 0;
+		for (int i = MAX_S-1; i > 0; --i)
+			spare[spares++] = i;
+		path[0].program = program;
+		path[0].metric = 0;
+		path[0].lvl = level;
+		path[0].off = 0;
+		path[0].count = 0;
+		stack[0] = 0;
+		depth = 1;
+		int rank = 0;
+		while (depth) {
+			int p = pop();
+			Path &cur = path[p];
+			while (true) {
+				int op = *cur.program;
+				if (op == 255) {
+					assert(cur.lvl == level);
+					if (!rank)
+						for (int i = 0; i < cur.count; ++i)
+							message[i] = mesg[MAX_N*p+i];
+					if (check(mesg + MAX_N * p)) {
+						for (int i = 0; i < cur.count; ++i)
+							message[i] = mesg[MAX_N*p+i];
+						return rank;
+					}
+					++rank;
+					release(p);
+					break;
+				}
+				if (op == 4 || op == 5 || op == 6 || op == 9) {
+					decide(p);
+					break;
+				}
+				cur.program = PolarCompiler::step(cur.program, cur.lvl, cur.off, [this, p](int op, int, int lvl, int off) {
+					switch (op) {
+					case 0: left(lvl, p); break;
+					case 1: right(lvl, p); break;
+					case 2: comb(lvl, off, p); break;
+					case 3: rate0(lvl, off, p); break;
+					case 7: rate0_right(lvl, p); break;
+					case 8: rate0_comb(lvl, off, p); break;
+					default: assert(false);
+					}
+				});
+			}
+		}
+		return -1;
+	}
+	int operator()(TYPE *message, const TYPE *codeword, const uint8_t *program, int list_size)
+	{
+		return (*this)(message, codeword, program, list_size, [](const TYPE *){ return true; });
+	}
+};
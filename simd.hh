@@ -9,6 +9,7 @@ Copyright 2018 Ahmet Inan <inan@aicodix.de>
 #include <cstdint>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
 
 template <typename TYPE, int WIDTH>
 union SIMD;
@@ -113,6 +114,60 @@ union SIMD<uint64_t, WIDTH>
 	uint_type u[SIZE];
 };
 
+struct half_t;
+
+template <int WIDTH>
+union SIMD<half_t, WIDTH>
+{
+	static const int SIZE = WIDTH;
+	typedef float value_type;
+	SIMD<uint16_t, WIDTH> m;
+};
+
+static inline float half_to_float(uint16_t h)
+{
+	uint32_t sign = uint32_t(h & 32768) << 16, exp = h >> 10 & 31, man = h & 1023, bits = 0;
+	if (exp == 31) {
+		bits = 0x7f800000 | man << 13;
+	} else if (exp) {
+		bits = (exp + 112) << 23 | man << 13;
+	} else if (man) {
+		for (exp = 113; !(man & 1024); --exp)
+			man <<= 1;
+		bits = exp << 23 | (man & 1023) << 13;
+	}
+	bits |= sign;
+	float f;
+	std::memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+static inline uint16_t float_to_half(float f)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &f, sizeof(bits));
+	uint16_t sign = bits >> 16 & 32768;
+	uint32_t mag = bits & 0x7fffffff, man, rem, half;
+	if (mag > 0x7f800000)
+		return sign | 32256;
+	if (mag >= 0x477ff000)
+		return sign | 31744;
+	if (mag < 0x33000000)
+		return sign;
+	if (mag < 0x38800000) {
+		int shift = 126 - (mag >> 23);
+		man = (mag & 0x7fffff) | 0x800000;
+		rem = man & ((1 << shift) - 1);
+		half = 1 << (shift - 1);
+		man >>= shift;
+	} else {
+		man = ((mag >> 23) - 112) << 10 | (mag >> 13 & 1023);
+		rem = mag & 8191;
+		half = 4096;
+	}
+	return sign | (man + (rem > half || (rem == half && (man & 1))));
+}
+
 template <typename TYPE>
 static inline TYPE vdup(typename TYPE::value_type a)
 {
@@ -1495,9 +1550,68 @@ static inline SIMD<double, WIDTH> vshuf(SIMD<double, WIDTH> a, SIMD<uint64_t, WI
 	return tmp;
 }
 
+template <int WIDTH>
+static inline SIMD<int16_t, WIDTH> vshr(SIMD<int16_t, WIDTH> a, int n)
+{
+	SIMD<int16_t, WIDTH> tmp;
+	for (int i = 0; i < WIDTH; ++i)
+		tmp.v[i] = a.v[i] >> n;
+	return tmp;
+}
+
+template <int WIDTH>
+static inline SIMD<int8_t, 2 * WIDTH> vqmovn(SIMD<int16_t, WIDTH> a, SIMD<int16_t, WIDTH> b)
+{
+	SIMD<int8_t, 2 * WIDTH> tmp;
+	for (int i = 0; i < WIDTH; ++i) {
+		tmp.v[i] = std::min<int16_t>(std::max<int16_t>(a.v[i], INT8_MIN), INT8_MAX);
+		tmp.v[i+WIDTH] = std::min<int16_t>(std::max<int16_t>(b.v[i], INT8_MIN), INT8_MAX);
+	}
+	return tmp;
+}
+
+template <int WIDTH>
+static inline SIMD<int16_t, WIDTH / 2> vmovl_low(SIMD<int8_t, WIDTH> a)
+{
+	SIMD<int16_t, WIDTH / 2> tmp;
+	for (int i = 0; i < WIDTH / 2; ++i)
+		tmp.v[i] = a.v[i];
+	return tmp;
+}
+
+template <int WIDTH>
+static inline SIMD<int16_t, WIDTH / 2> vmovl_high(SIMD<int8_t, WIDTH> a)
+{
+	SIMD<int16_t, WIDTH / 2> tmp;
+	for (int i = 0; i < WIDTH / 2; ++i)
+		tmp.v[i] = a.v[i+WIDTH/2];
+	return tmp;
+}
+
+template <int WIDTH>
+static inline SIMD<float, WIDTH> vcvt_float(SIMD<uint16_t, WIDTH> a)
+{
+	SIMD<float, WIDTH> tmp;
+	for (int i = 0; i < WIDTH; ++i)
+		tmp.v[i] = half_to_float(a.v[i]);
+	return tmp;
+}
+
+template <int WIDTH>
+static inline SIMD<uint16_t, WIDTH> vcvt_half(SIMD<float, WIDTH> a)
+{
+	SIMD<uint16_t, WIDTH> tmp;
+	for (int i = 0; i < WIDTH; ++i)
+		tmp.v[i] = float_to_half(a.v[i]);
+	return tmp;
+}
+
 #if 1
 #ifdef __AVX2__
 #include "avx2.hh"
+#ifdef __AVX512F__
+#include "avx512.hh"
+#endif
 #else
 #ifdef __SSE4_1__
 #include "sse4_1.hh"
@@ -470,6 +470,14 @@ inline SIMD<double, 2> vmul(SIMD<double, 2> a, SIMD<double, 2> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 8> vmul(SIMD<int16_t, 8> a, SIMD<int16_t, 8> b)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = _mm_mullo_epi16(a.m, b.m);
+	return tmp;
+}
+
 template <>
 inline SIMD<float, 4> vabs(SIMD<float, 4> a)
 {
@@ -1165,3 +1173,54 @@ inline SIMD<int8_t, 16> vshuf(SIMD<int8_t, 16> a, SIMD<uint8_t, 16> b)
 	return tmp;
 }
 
+template <>
+inline SIMD<int16_t, 8> vshr(SIMD<int16_t, 8> a, int n)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = _mm_sra_epi16(a.m, _mm_cvtsi32_si128(n));
+	return tmp;
+}
+
+template <>
+inline SIMD<int8_t, 16> vqmovn(SIMD<int16_t, 8> a, SIMD<int16_t, 8> b)
+{
+	SIMD<int8_t, 16> tmp;
+	tmp.m = _mm_packs_epi16(a.m, b.m);
+	return tmp;
+}
+
+template <>
+inline SIMD<int16_t, 8> vmovl_low(SIMD<int8_t, 16> a)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = _mm_cvtepi8_epi16(a.m);
+	return tmp;
+}
+
+template <>
+inline SIMD<int16_t, 8> vmovl_high(SIMD<int8_t, 16> a)
+{
+	SIMD<int16_t, 8> tmp;
+	tmp.m = _mm_cvtepi8_epi16(_mm_srli_si128(a.m, 8));
+	return tmp;
+}
+
+#ifdef __F16C__
+#include <immintrin.h>
+
+template <>
+inline SIMD<float, 4> vcvt_float(SIMD<uint16_t, 4> a)
+{
+	SIMD<float, 4> tmp;
+	tmp.m = _mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)a.v));
+	return tmp;
+}
+
+template <>
+inline SIMD<uint16_t, 4> vcvt_half(SIMD<float, 4> a)
+{
+	SIMD<uint16_t, 4> tmp;
+	_mm_storel_epi64((__m128i *)tmp.v, _mm_cvtps_ph(a.m, _MM_FROUND_TO_NEAREST_INT));
+	return tmp;
+}
+#endif
@@ -0,0 +1,117 @@
+/*
+Test bench for successive cancellation stack decoding of polar codes
+
+Copyright 2020 Ahmet Inan <xdsopl@gmail.com>
+*/
+
+#include <limits>
+#include <stdlib.h>
+#include <random>
+#include <chrono>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include "simd.hh"
+#include "crc.hh"
+#include "polar_helper.hh"
+#include "polar_compiler.hh"
+#include "polar_decoder.hh"
+#include "polar_encoder.hh"
+#include "polar_freezer.hh"
+#include "polar_stack_decoder.hh"
+
+int main()
+{
+	const int M = 10;
+	const int N = 1 << M;
+	const int L = 16;
+	const int C = 16;
+	typedef int8_t code_type;
+	typedef std::default_random_engine generator;
+	typedef std::uniform_int_distribution<int> distribution;
+	auto data = std::bind(distribution(0, 1), generator(1));
+	auto frozen = new uint8_t[N];
+	auto codeword = new code_type[N];
+
+	long double erasure_probability = 0.5;
+	int K = (1 - erasure_probability) * N;
+	double design_SNR = 10 * std::log10(-std::log(erasure_probability));
+	{
+		auto freeze = new PolarCodeConst0<M>;
+		long double probability = std::exp(-pow(10.0, (design_SNR + 1.59175) / 10));
+		(*freeze)(frozen, M, K, probability);
+		delete freeze;
+	}
+	std::cerr << "Polar(" << N << ", " << K << ") with CRC" << C << " and list size " << L << std::endl;
+	auto message = new code_type[K];
+	auto decoded = new code_type[K];
+	PolarEncoder<code_type, M> encode;
+	auto program = new uint8_t[N];
+	PolarCompiler compile;
+	compile(program, frozen, M);
+	std::cerr << "sizeof(PolarStackDecoder<code_type, M>) = " << sizeof(PolarStackDecoder<code_type, M>) << std::endl;
+	auto stack = new PolarStackDecoder<code_type, M>;
+	auto list = new PolarListDecoder<code_type, M, L>;
+	CRC<uint16_t> crc(0x8408);
+	auto check = [&](const code_type *mesg) {
+		crc.reset();
+		for (int i = 0; i < K; ++i)
+			crc(mesg[i] < 0);
+		return !crc();
+	};
+
+	auto symb = new double[N];
+	std::cerr << "SNR FER(SCL) FER(SCS) Mbit/s(SCL) Mbit/s(SCS)" << std::endl;
+	for (double SNR = -1.5; SNR <= 0; SNR += 0.5) {
+		double sigma_signal = 1;
+		double mean_noise = 0;
+		double sigma_noise = std::sqrt(sigma_signal * sigma_signal / (2 * std::pow(10, SNR / 10)));
+
+		typedef std::normal_distribution<double> normal;
+		auto awgn = std::bind(normal(mean_noise, sigma_noise), generator(2));
+
+		int64_t frame_errors[2] = { 0 };
+		double usec[2] = { 0 };
+		int64_t loops = 4000;
+		for (int64_t loop = 0; loop < loops; ++loop) {
+			crc.reset();
+			for (int i = 0; i < K - C; ++i)
+				crc((message[i] = 1 - 2 * data()) < 0);
+			for (int i = 0, parity = crc(); i < C; ++i)
+				message[K-C+i] = 1 - 2 * ((parity >> i) & 1);
+			encode(codeword, message, frozen);
+
+			for (int i = 0; i < N; ++i)
+				symb[i] = codeword[i] + awgn();
+
+			double DIST = 2; // BPSK
+			double fact = DIST / (sigma_noise * sigma_noise);
+			for (int i = 0; i < N; ++i)
+				codeword[i] = PolarHelper<code_type>::quant(fact * symb[i]);
+
+			for (int d = 0; d < 2; ++d) {
+				auto start = std::chrono::system_clock::now();
+				if (d)
+					(*stack)(decoded, codeword, program, L, check);
+				else
+					(*list)(decoded, codeword, program, L, check);
+				auto end = std::chrono::system_clock::now();
+				usec[d] += std::chrono::duration<double, std::micro>(end - start).count();
+				int errors = 0;
+				for (int i = 0; i < K; ++i)
+					errors += decoded[i] * message[i] <= 0;
+				frame_errors[d] += !!errors;
+			}
+		}
+
+		std::cout << SNR;
+		for (int d = 0; d < 2; ++d)
+			std::cout << " " << (double)frame_errors[d] / (double)loops;
+		for (int d = 0; d < 2; ++d)
+			std::cout << " " << (double)(loops * K) / usec[d];
+		std::cout << std::endl;
+	}
+	return 0;
+}
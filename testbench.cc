@@ -48,6 +48,8 @@ int main()
 	const bool systematic = true;
 #if 1
 	typedef int8_t code_type;
+#elif 0
+	typedef int16_t code_type;
 #else
 	typedef float code_type;
 #endif